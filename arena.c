@@ -0,0 +1,144 @@
+/*
+ * Bump allocator for graph objects.
+ */
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define DEFAULT_CHUNK_SIZE (1 << 20)
+#define ALIGNMENT alignof(max_align_t)
+
+typedef struct chunk
+{
+  struct chunk* next;
+  size_t size;             // usable bytes after the header
+  size_t used;
+} Chunk;
+
+// the chunk header is padded so that the first allocation is aligned
+#define HEADER_SIZE ((sizeof(Chunk) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+struct arena
+{
+  Chunk* chunks;           // most recent chunk first
+  size_t chunkSize;
+  size_t numChunks;
+  size_t bytes;
+};
+
+static _Thread_local Arena* currentArena = NULL;
+
+/*
+ * Chunks come from calloc, so allocations need no zeroing of their own.
+ */
+static Chunk* newChunk(size_t size) {
+    Chunk* chunk = (Chunk*)calloc(1, HEADER_SIZE + size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+Arena* newArena(size_t chunkSize) {
+    Arena* arena = (Arena*)calloc(1, sizeof(Arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->chunkSize = chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE;
+    return arena;
+}
+
+void deleteArena(Arena* arena) {
+    if (!arena) return;
+    Chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        Chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    if (currentArena == arena) {
+        currentArena = NULL;
+    }
+    free(arena);
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    if (arena == NULL) {
+        return NULL;
+    }
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    Chunk* chunk = arena->chunks;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        // oversized requests get a chunk of their own
+        chunk = newChunk(size > arena->chunkSize ? size : arena->chunkSize);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->numChunks++;
+        arena->bytes += chunk->size;
+    }
+    void* ptr = (char*)chunk + HEADER_SIZE + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+void arenaReset(Arena* arena) {
+    if (arena == NULL || arena->chunks == NULL) {
+        return;
+    }
+    // keep the most recent chunk, free the rest
+    Chunk* chunk = arena->chunks->next;
+    while (chunk != NULL) {
+        Chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks->next = NULL;
+    // the kept chunk must read as zeroed again
+    memset((char*)arena->chunks + HEADER_SIZE, 0, arena->chunks->used);
+    arena->chunks->used = 0;
+    arena->numChunks = 1;
+    arena->bytes = arena->chunks->size;
+}
+
+size_t arenaNumChunks(Arena* arena) {
+    return arena == NULL ? 0 : arena->numChunks;
+}
+
+size_t arenaBytes(Arena* arena) {
+    return arena == NULL ? 0 : arena->bytes;
+}
+
+Arena* setCurrentArena(Arena* arena) {
+    Arena* previous = currentArena;
+    currentArena = arena;
+    return previous;
+}
+
+Arena* getCurrentArena(void) {
+    return currentArena;
+}
+
+void* arenaCalloc(size_t count, size_t size) {
+    if (currentArena != NULL) {
+        if (size != 0 && count > (size_t)-1 / size) {
+            return NULL;
+        }
+        return arenaAlloc(currentArena, count * size);
+    }
+    return calloc(count, size);
+}
+
+void arenaFree(void* ptr) {
+    if (currentArena == NULL) {
+        free(ptr);
+    }
+}
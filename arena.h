@@ -0,0 +1,64 @@
+/*
+ * Bump allocator for graph objects.
+ *
+ * An Arena hands out memory from large chunks and frees all of it at
+ * once. Each thread can have a current arena; while one is set, newEdge,
+ * newEdgeList and newVertex allocate from it, which is how the nodes of
+ * an arena graph are made (see newArenaGraph). Who owns a node is fixed
+ * when it is allocated: memory from an arena is only ever released with
+ * the arena, never by deleteEdgeList or deleteVertex.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct arena Arena;
+
+/*
+ * Creates and returns an empty arena that allocates chunks of
+ * 'chunkSize' bytes (a default size if 0). Returns NULL on allocation
+ * failure.
+ */
+Arena* newArena(size_t chunkSize);
+
+/*
+ * Frees every chunk of 'arena' and 'arena' itself.
+ */
+void deleteArena(Arena* arena);
+
+/*
+ * Returns 'size' zeroed bytes from 'arena', aligned for any type, or NULL
+ * on allocation failure. The memory stays valid until 'arena' is reset
+ * or deleted.
+ */
+void* arenaAlloc(Arena* arena, size_t size);
+
+/*
+ * Makes every allocation of 'arena' invalid, keeping one chunk for reuse.
+ */
+void arenaReset(Arena* arena);
+
+size_t arenaNumChunks(Arena* arena);
+size_t arenaBytes(Arena* arena);  // bytes reserved in chunks
+
+/*
+ * Sets the current arena of the calling thread ('arena' may be NULL for
+ * none) and returns the previous one.
+ */
+Arena* setCurrentArena(Arena* arena);
+Arena* getCurrentArena(void);
+
+/*
+ * calloc and free through the current arena: arenaCalloc allocates from
+ * it if one is set and from calloc otherwise, and arenaFree does nothing
+ * if one is set. A pointer must be given to arenaFree under the same
+ * current arena as the arenaCalloc that returned it, so these only pair
+ * up within a scope that pins the current arena to the owner of what it
+ * builds.
+ */
+void* arenaCalloc(size_t count, size_t size);
+void arenaFree(void* ptr);
+
+#endif
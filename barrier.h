@@ -0,0 +1,49 @@
+/*
+ * A reusable barrier for worker threads that run in lockstep phases:
+ * every thread waits in barrierWait until 'count' threads have arrived,
+ * and the barrier is then ready for the next phase.
+ */
+
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <pthread.h>
+
+typedef struct barrier
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int count;                // threads that must arrive
+  int waiting;              // threads that have arrived in this phase
+  unsigned int generation;  // phases completed
+} Barrier;
+
+static inline void barrierInit(Barrier* b, int count) {
+    pthread_mutex_init(&b->mutex, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->count = count;
+    b->waiting = 0;
+    b->generation = 0;
+}
+
+static inline void barrierDestroy(Barrier* b) {
+    pthread_mutex_destroy(&b->mutex);
+    pthread_cond_destroy(&b->cond);
+}
+
+static inline void barrierWait(Barrier* b) {
+    pthread_mutex_lock(&b->mutex);
+    unsigned int generation = b->generation;
+    if (++b->waiting == b->count) {
+        b->waiting = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->cond);
+    } else {
+        while (generation == b->generation) {
+            pthread_cond_wait(&b->cond, &b->mutex);
+        }
+    }
+    pthread_mutex_unlock(&b->mutex);
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Graph load and teardown time with per-object calloc/free against an
+ * arena-owning graph, and the same for the paths of getShortestPaths.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_arena.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [numVertices] [numEdges]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "arena.h"
+
+/*
+ * Adds 'numEdges' random edges to 'graph', with the same sequence for
+ * the same seed.
+ */
+static void addRandomEdges(Graph* graph, int numEdges, uint64_t seed) {
+    uint64_t state = seed;
+    int n = graph->numVertices;
+    for (int i = 0; i < numEdges; i++) {
+        int u = benchRandomRange(&state, 0, n - 1);
+        int v = benchRandomRange(&state, 0, n - 1);
+        int w = benchRandomRange(&state, 1, 100);
+        graph->vertices[u]->adjList = newEdgeList(newEdge(u, v, w), graph->vertices[u]->adjList);
+        graph->numEdges++;
+    }
+}
+
+int main(int argc, char** argv) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    int numEdges = argc > 2 ? atoi(argv[2]) : 5000000;
+    if (numVertices < 2 || numEdges < 0) {
+        fprintf(stderr, "usage: %s [numVertices >= 2] [numEdges >= 0]\n", argv[0]);
+        return 1;
+    }
+    double start = benchNow();
+    Graph* graph = newGraph(numVertices);
+    addRandomEdges(graph, numEdges, 42);
+    double callocLoad = benchNow() - start;
+    start = benchNow();
+    deleteGraph(graph);
+    double callocTeardown = benchNow() - start;
+
+    start = benchNow();
+    graph = newArenaGraph(numVertices, 0);
+    Arena* previous = setCurrentArena(graph->arena);
+    addRandomEdges(graph, numEdges, 42);
+    setCurrentArena(previous);
+    double arenaLoad = benchNow() - start;
+    size_t numChunks = arenaNumChunks(graph->arena);
+
+    // all paths from one source, freed node by node or with their arena
+    Edge* distTree = getDistanceTreeDijkstraPQ(graph, 0, PQ_LAZY_HEAP);
+    start = benchNow();
+    EdgeList** paths = getShortestPaths(distTree, numVertices, 0);
+    double pathsBuild = benchNow() - start;
+    start = benchNow();
+    for (int i = 0; i < numVertices; i++) {
+        deleteEdgeList(paths[i]);
+    }
+    free(paths);
+    double pathsTeardown = benchNow() - start;
+
+    Arena* pathArena = newArena(0);
+    start = benchNow();
+    paths = getShortestPathsArena(distTree, numVertices, 0, pathArena);
+    double arenaPathsBuild = benchNow() - start;
+    start = benchNow();
+    deleteArena(pathArena);
+    double arenaPathsTeardown = benchNow() - start;
+    free(distTree);
+
+    start = benchNow();
+    deleteGraph(graph);
+    double arenaTeardown = benchNow() - start;
+
+    printf("%d vertices, %d edges, arena graph in %zu chunks\n", numVertices, numEdges,
+           numChunks);
+    printf("%-16s %12s %14s\n", "", "build (s)", "teardown (s)");
+    printf("%-16s %12.3f %14.3f\n", "graph, calloc", callocLoad, callocTeardown);
+    printf("%-16s %12.3f %14.3f\n", "graph, arena", arenaLoad, arenaTeardown);
+    printf("%-16s %12.3f %14.3f\n", "paths, calloc", pathsBuild, pathsTeardown);
+    printf("%-16s %12.3f %14.3f\n", "paths, arena", arenaPathsBuild, arenaPathsTeardown);
+    return 0;
+}
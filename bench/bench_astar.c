@@ -0,0 +1,98 @@
+/*
+ * A* against plain Dijkstra on a geometric grid: settled vertices per
+ * query and p50/p99 latency for the Euclidean and ALT heuristics.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_astar.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [gridSide] [numQueries] [numLandmarks]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+
+#define NUM_MODES 3
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 200;
+    int numQueries = argc > 2 ? atoi(argv[2]) : 200;
+    int numLandmarks = argc > 3 ? atoi(argv[3]) : 8;
+    if (side < 2 || numQueries < 1 || numLandmarks < 1) {
+        fprintf(stderr, "usage: %s [gridSide >= 2] [numQueries >= 1] [numLandmarks >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+    // grid cells one unit apart, weights 100..120 per unit of length, so
+    // the straight-line distance is a good lower bound
+    Graph* graph = newGraph(side * side);
+    if (graph == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    uint64_t state = 42;
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int u = r * side + c;
+            setVertexCoordinates(graph, u, c, r);
+            if (c + 1 < side) {
+                benchAddUndirected(graph, u, u + 1, benchRandomRange(&state, 100, 120));
+            }
+            if (r + 1 < side) {
+                benchAddUndirected(graph, u, u + side, benchRandomRange(&state, 100, 120));
+            }
+        }
+    }
+    int n = graph->numVertices;
+    double scale = getAdmissibleScale(graph, euclideanDistance);
+    double start = benchNow();
+    Landmarks* landmarks = newLandmarks(graph, NULL, numLandmarks);
+    double landmarkTime = benchNow() - start;
+
+    const char* names[NUM_MODES] = {"Dijkstra", "A* Euclidean", "A* ALT"};
+    Heuristic heuristics[NUM_MODES] = {NULL, euclideanHeuristic, altHeuristic};
+    void* data[NUM_MODES] = {NULL, &scale, landmarks};
+    double* times[NUM_MODES];
+    long totalSettled[NUM_MODES] = {0};
+    for (int m = 0; m < NUM_MODES; m++) {
+        times[m] = (double*)malloc(numQueries * sizeof(double));
+    }
+    int mismatches = 0;
+    state = 7;
+    for (int q = 0; q < numQueries; q++) {
+        int s = benchRandomRange(&state, 0, n - 1);
+        int t = benchRandomRange(&state, 0, n - 1);
+        long expected = 0;
+        for (int m = 0; m < NUM_MODES; m++) {
+            int settled;
+            start = benchNow();
+            EdgeList* path = getShortestPathAStar(graph, s, t, heuristics[m], data[m], &settled);
+            times[m][q] = benchNow() - start;
+            totalSettled[m] += settled;
+            if (m == 0) {
+                expected = benchPathWeight(path);
+            } else if (benchPathWeight(path) != expected) {
+                mismatches++;
+            }
+            deleteEdgeList(path);
+        }
+    }
+    printf("grid %dx%d, %d vertices, %d edges, %d queries\n", side, side, n,
+           graph->numEdges, numQueries);
+    printf("Euclidean scale %.2f, %d landmarks in %.1f ms\n", scale, numLandmarks,
+           1e3 * landmarkTime);
+    printf("%-14s %14s %12s %12s\n", "", "avg settled", "p50 (ms)", "p99 (ms)");
+    for (int m = 0; m < NUM_MODES; m++) {
+        printf("%-14s %14.1f %12.3f %12.3f\n", names[m],
+               (double)totalSettled[m] / numQueries,
+               1e3 * benchPercentile(times[m], numQueries, 50),
+               1e3 * benchPercentile(times[m], numQueries, 99));
+        free(times[m]);
+    }
+    if (mismatches > 0) {
+        printf("WARNING: %d path weights differ from Dijkstra\n", mismatches);
+    }
+    deleteLandmarks(landmarks);
+    deleteGraph(graph);
+    return mismatches > 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Distance tree cache on a skewed query mix: point-to-point queries whose
+ * sources follow a Zipf distribution over a few hundred popular vertices,
+ * with an occasional edge update that invalidates the cache, answered by
+ * getDistanceTreeDijkstra + getShortestPaths, by getShortestPath, and by
+ * getCachedShortestPath under several memory budgets.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_cache.c cache.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rows] [cols] [queries] [updateEvery]
+ */
+
+#include "bench/bench_util.h"
+#include <math.h>
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "cache.h"
+
+#define NUM_POPULAR 256
+
+typedef struct query
+{
+  int source;
+  int target;
+} Query;
+
+/*
+ * Fills 'queries' with sources drawn by Zipf (s = 1) from NUM_POPULAR
+ * random vertices and uniformly random targets.
+ */
+static void makeQueries(Query* queries, int numQueries, int numVertices, uint64_t* state) {
+    int popular[NUM_POPULAR];
+    double cumulative[NUM_POPULAR];
+    double total = 0;
+    for (int i = 0; i < NUM_POPULAR; i++) {
+        popular[i] = benchRandomRange(state, 0, numVertices - 1);
+        total += 1.0 / (i + 1);
+        cumulative[i] = total;
+    }
+    for (int q = 0; q < numQueries; q++) {
+        double x = (double)(benchRandom(state) >> 11) / (double)(1ULL << 53) * total;
+        int i = 0;
+        while (i < NUM_POPULAR - 1 && cumulative[i] < x) {
+            i++;
+        }
+        queries[q].source = popular[i];
+        queries[q].target = benchRandomRange(state, 0, numVertices - 1);
+    }
+}
+
+/*
+ * Reweights a random edge and its reverse, which bumps graph->version.
+ */
+static void updateEdge(Graph* graph, uint64_t* state) {
+    int u = benchRandomRange(state, 0, graph->numVertices - 1);
+    int v = graph->vertices[u]->adjList->edge->toVertex;
+    int weight = benchRandomRange(state, 1, 1000);
+    setEdgeWeight(graph, u, v, weight);
+    setEdgeWeight(graph, v, u, weight);
+}
+
+/*
+ * Answers 'queries' on a fresh grid, reweighting an edge every
+ * 'updateEvery' queries, with getShortestPath if 'cacheTrees' is 0 and
+ * through a cache of that many trees otherwise, and prints a result row.
+ * Every run sees the same graphs, so the checksums must agree.
+ */
+static void runQueries(int rows, int cols, Query* queries, int numQueries, int updateEvery,
+                       int cacheTrees) {
+    Graph* graph = benchGridGraph(rows, cols, 1000, 42);
+    size_t treeBytes = graph->numVertices * sizeof(Edge);
+    DistanceCache* cache = NULL;
+    if (cacheTrees > 0) {
+        cache = newDistanceCache(graph, cacheTrees * (treeBytes + 64));
+    }
+    uint64_t updates = 11;
+    long checksum = 0;
+    double start = benchNow();
+    for (int q = 0; q < numQueries; q++) {
+        if (q > 0 && q % updateEvery == 0) {
+            updateEdge(graph, &updates);
+        }
+        EdgeList* path = cache != NULL
+            ? getCachedShortestPath(cache, queries[q].source, queries[q].target)
+            : getShortestPath(graph, queries[q].source, queries[q].target);
+        checksum += benchPathWeight(path);
+        deleteEdgeList(path);
+    }
+    double elapsed = benchNow() - start;
+    if (cache == NULL) {
+        printf("%-26s %10.3f %8s %8s %10s %12s %10ld\n", "getShortestPath",
+               1000 * elapsed / numQueries, "-", "-", "-", "-", checksum);
+    } else {
+        DistanceCacheStats stats = getDistanceCacheStats(cache);
+        char name[40];
+        snprintf(name, sizeof(name), "cache, %d trees", cacheTrees);
+        printf("%-26s %10.3f %8ld %8ld %10ld %12ld %10ld\n", name, 1000 * elapsed / numQueries,
+               stats.hits, stats.misses, stats.evictions, stats.invalidations, checksum);
+        deleteDistanceCache(cache);
+    }
+    deleteGraph(graph);
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? atoi(argv[1]) : 100;
+    int cols = argc > 2 ? atoi(argv[2]) : 100;
+    int numQueries = argc > 3 ? atoi(argv[3]) : 2000;
+    int updateEvery = argc > 4 ? atoi(argv[4]) : 500;
+    if (rows < 1 || cols < 2 || numQueries < 1 || updateEvery < 1) {
+        fprintf(stderr, "usage: %s [rows >= 1] [cols >= 2] [queries >= 1] [updateEvery >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(rows, cols, 1000, 42);
+    int n = graph->numVertices;
+    uint64_t state = 7;
+    Query* queries = (Query*)malloc(numQueries * sizeof(Query));
+    makeQueries(queries, numQueries, n, &state);
+    size_t treeBytes = n * sizeof(Edge);
+    printf("%dx%d grid, %d queries, an update every %d, %zu KiB per tree\n", rows, cols,
+           numQueries, updateEvery, treeBytes / 1024);
+    printf("%-26s %10s %8s %8s %10s %12s %10s\n", "", "ms / query", "hits", "misses",
+           "evictions", "invalidated", "checksum");
+
+    // getShortestPaths builds every path, so time it on a sample only
+    int sample = numQueries < 100 ? numQueries : 100;
+    double start = benchNow();
+    for (int q = 0; q < sample; q++) {
+        Edge* distTree = getDistanceTreeDijkstra(graph, queries[q].source);
+        EdgeList** paths = getShortestPaths(distTree, n, queries[q].source);
+        for (int v = 0; v < n; v++) {
+            deleteEdgeList(paths[v]);
+        }
+        free(paths);
+        free(distTree);
+    }
+    printf("%-26s %10.3f %8s %8s %10s %12s %10s\n", "tree + getShortestPaths",
+           1000 * (benchNow() - start) / sample, "-", "-", "-", "-", "-");
+
+    deleteGraph(graph);
+
+    runQueries(rows, cols, queries, numQueries, updateEvery, 0);
+    int budgets[4] = {8, 32, 128, 512};
+    for (int b = 0; b < 4; b++) {
+        runQueries(rows, cols, queries, numQueries, updateEvery, budgets[b]);
+    }
+    free(queries);
+    return 0;
+}
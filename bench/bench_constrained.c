@@ -0,0 +1,144 @@
+/*
+ * Constrained shortest paths on a toll road grid: slow free streets,
+ * with every tenth row and column a fast highway whose edges charge a
+ * toll and some of whose bridges are low. Point-to-point queries under
+ * toll budgets from unlimited down to zero, with and without a truck
+ * that needs clearance, against getShortestPath, reporting labels
+ * created and the peak held by the pool.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_constrained.c constrained.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [side] [queries] [maxLabels]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "constrained.h"
+
+#define TOLL 0
+#define CLEARANCE 1
+
+/*
+ * Adds u -- v in both directions with the same weight and attributes.
+ */
+static void addRoad(Graph* graph, int u, int v, int weight, int toll, int clearance) {
+    int costs[2];
+    costs[TOLL] = toll;
+    costs[CLEARANCE] = clearance;
+    insertCostEdge(graph, u, v, weight, costs);
+    insertCostEdge(graph, v, u, weight, costs);
+}
+
+static Graph* tollGrid(int side, uint64_t seed) {
+    Graph* graph = newGraph(side * side);
+    setNumCosts(graph, 2);
+    uint64_t state = seed | 1;
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int u = r * side + c;
+            if (c + 1 < side) {
+                bool highway = r % 10 == 0;
+                addRoad(graph, u, u + 1,
+                        highway ? benchRandomRange(&state, 5, 15) : benchRandomRange(&state, 40, 100),
+                        highway ? benchRandomRange(&state, 1, 5) : 0,
+                        highway && benchRandomRange(&state, 0, 9) == 0 ? 3 : 5);
+            }
+            if (r + 1 < side) {
+                bool highway = c % 10 == 0;
+                addRoad(graph, u, u + side,
+                        highway ? benchRandomRange(&state, 5, 15) : benchRandomRange(&state, 40, 100),
+                        highway ? benchRandomRange(&state, 1, 5) : 0,
+                        highway && benchRandomRange(&state, 0, 9) == 0 ? 3 : 5);
+            }
+        }
+    }
+    return graph;
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 60;
+    int numQueries = argc > 2 ? atoi(argv[2]) : 50;
+    int maxLabels = argc > 3 ? atoi(argv[3]) : 1 << 22;
+    if (side < 2 || numQueries < 1 || maxLabels < 0) {
+        fprintf(stderr, "usage: %s [side >= 2] [queries >= 1] [maxLabels >= 0]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = tollGrid(side, 42);
+    int n = graph->numVertices;
+    uint64_t state = 7;
+    int* sources = (int*)malloc(numQueries * sizeof(int));
+    int* targets = (int*)malloc(numQueries * sizeof(int));
+    for (int q = 0; q < numQueries; q++) {
+        sources[q] = benchRandomRange(&state, 0, n - 1);
+        do {
+            targets[q] = benchRandomRange(&state, 0, n - 1);
+        } while (targets[q] == sources[q]);
+    }
+    printf("%dx%d toll grid, %d edges, %d queries, at most %d labels\n", side, side,
+           graph->numEdges, numQueries, maxLabels);
+    printf("%-30s %10s %8s %12s %12s %10s\n", "", "ms / query", "found", "labels / q",
+           "peak labels", "weight");
+
+    long weight = 0;
+    int found = 0;
+    double start = benchNow();
+    for (int q = 0; q < numQueries; q++) {
+        EdgeList* path = getShortestPath(graph, sources[q], targets[q]);
+        if (path != NULL) {
+            weight += benchPathWeight(path);
+            found++;
+        }
+        deleteEdgeList(path);
+    }
+    printf("%-30s %10.3f %8d %12s %12s %10ld\n", "getShortestPath",
+           1000 * (benchNow() - start) / numQueries, found, "-", "-", weight);
+
+    int budgets[5] = {-1, 40, 20, 5, 0};
+    for (int truck = 0; truck < 2; truck++) {
+        for (int b = 0; b < 5; b++) {
+            Constraint constraints[2];
+            constraints[TOLL].kind = budgets[b] < 0 ? CONSTRAINT_NONE : CONSTRAINT_SUM;
+            constraints[TOLL].bound = budgets[b];
+            constraints[CLEARANCE].kind = truck ? CONSTRAINT_EDGE_MIN : CONSTRAINT_NONE;
+            constraints[CLEARANCE].bound = 4;
+            long labels = 0;
+            long peak = 0;
+            int exhausted = 0;
+            weight = 0;
+            found = 0;
+            start = benchNow();
+            for (int q = 0; q < numQueries; q++) {
+                ConstrainedStats stats;
+                EdgeList* path = getConstrainedShortestPath(graph, sources[q], targets[q],
+                                                            constraints, maxLabels, &stats);
+                if (path != NULL) {
+                    weight += benchPathWeight(path);
+                    found++;
+                }
+                deleteEdgeList(path);
+                labels += stats.labelsCreated;
+                peak = stats.peakLabels > peak ? stats.peakLabels : peak;
+                exhausted += stats.exhausted;
+            }
+            double elapsed = benchNow() - start;
+            char name[48];
+            if (budgets[b] < 0) {
+                snprintf(name, sizeof(name), "%s, any toll", truck ? "truck" : "car");
+            } else {
+                snprintf(name, sizeof(name), "%s, toll <= %d", truck ? "truck" : "car", budgets[b]);
+            }
+            printf("%-30s %10.3f %8d %12ld %12ld %10ld", name, 1000 * elapsed / numQueries,
+                   found, labels / numQueries, peak, weight);
+            if (exhausted > 0) {
+                printf("  (%d hit maxLabels)", exhausted);
+            }
+            printf("\n");
+        }
+    }
+    free(sources);
+    free(targets);
+    deleteGraph(graph);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Delta-stepping scaling at 1, 2, 4, 8 and 16 threads, each run checked
+ * against getDistanceTreeDijkstra.
+ *
+ * Build from the repository root:
+ *   cc -O2 -pthread -I. bench/bench_delta.c graph.c graph_algos.c pq.c csr.c deltastep.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [gridSide] [delta] [numRuns]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "csr.h"
+#include "deltastep.h"
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 500;
+    int delta = argc > 2 ? atoi(argv[2]) : 0;
+    int numRuns = argc > 3 ? atoi(argv[3]) : 3;
+    if (side < 2 || numRuns < 1) {
+        fprintf(stderr, "usage: %s [gridSide >= 2] [delta, 0 = auto] [numRuns >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(side, side, 100, 42);
+    CSRGraph* csr = newCSRGraph(graph);
+    if (graph == NULL || csr == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    int n = graph->numVertices;
+    int source = n / 2;
+    double start = benchNow();
+    Edge* expected = getDistanceTreeDijkstra(graph, source);
+    double dijkstraTime = benchNow() - start;
+    printf("grid %dx%d, %d vertices, %d edges, delta %d\n", side, side, n,
+           graph->numEdges, delta);
+    printf("getDistanceTreeDijkstra: %.3f s\n", dijkstraTime);
+    printf("%8s %12s %14s %10s\n", "threads", "best (s)", "edges/s", "speedup");
+    int mismatches = 0;
+    double baseline = 0.0;
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        double best = 0.0;
+        for (int run = 0; run < numRuns; run++) {
+            start = benchNow();
+            Edge* distTree = getDistanceTreeDeltaSteppingCSR(csr, source, delta, threads);
+            double elapsed = benchNow() - start;
+            if (run == 0 || elapsed < best) {
+                best = elapsed;
+            }
+            for (int v = 0; v < n; v++) {
+                if (distTree == NULL || distTree[v].weight != expected[v].weight) {
+                    mismatches++;
+                }
+            }
+            free(distTree);
+        }
+        if (threads == 1) {
+            baseline = best;
+        }
+        printf("%8d %12.3f %14.0f %10.2f\n", threads, best, csr->numEdges / best,
+               baseline / best);
+    }
+    if (mismatches > 0) {
+        printf("WARNING: %d distances differ from getDistanceTreeDijkstra\n", mismatches);
+    }
+    free(expected);
+    deleteCSRGraph(csr);
+    deleteGraph(graph);
+    return mismatches > 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Narrow against wide distances: the same Dijkstra engine with int32_t,
+ * int64_t and double distances, next to getDistanceTreeDijkstra.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_distance.c distance.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rows] [cols] [runs]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "distance.h"
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? atoi(argv[1]) : 300;
+    int cols = argc > 2 ? atoi(argv[2]) : 300;
+    int runs = argc > 3 ? atoi(argv[3]) : 10;
+    if (rows < 1 || cols < 2 || runs < 1) {
+        fprintf(stderr, "usage: %s [rows >= 1] [cols >= 2] [runs >= 1]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(rows, cols, 1000, 42);
+    int n = graph->numVertices;
+    int64_t bound = getMaxPathWeight(graph);
+    printf("%dx%d grid, max path weight bound %lld: int32_t is %s\n", rows, cols,
+           (long long)bound, bound < DISTANCE32_INFINITY ? "safe" : "NOT safe");
+
+    double times[4] = {0, 0, 0, 0};
+    long checksums[4] = {0, 0, 0, 0};
+    uint64_t state = 7;
+    for (int r = 0; r < runs; r++) {
+        int source = benchRandomRange(&state, 0, n - 1);
+        int probe = benchRandomRange(&state, 0, n - 1);
+
+        double start = benchNow();
+        Edge* distTree = getDistanceTreeDijkstra(graph, source);
+        times[0] += benchNow() - start;
+        checksums[0] += distTree[probe].weight;
+        free(distTree);
+
+        start = benchNow();
+        DistanceTree32* narrow = getDistanceTree32(graph, source);
+        times[1] += benchNow() - start;
+        checksums[1] += narrow->distances[probe];
+        deleteDistanceTree32(narrow);
+
+        start = benchNow();
+        DistanceTree64* wide = getDistanceTree64(graph, source);
+        times[2] += benchNow() - start;
+        checksums[2] += wide->distances[probe];
+        deleteDistanceTree64(wide);
+
+        start = benchNow();
+        DistanceTreeDouble* real = getDistanceTreeDouble(graph, source, NULL, NULL);
+        times[3] += benchNow() - start;
+        checksums[3] += (long)real->distances[probe];
+        deleteDistanceTreeDouble(real);
+    }
+    const char* names[4] = {"getDistanceTreeDijkstra", "int32_t", "int64_t", "double"};
+    printf("%-24s %12s %12s\n", "", "ms / tree", "checksum");
+    for (int i = 0; i < 4; i++) {
+        printf("%-24s %12.2f %12ld\n", names[i], 1000 * times[i] / runs, checksums[i]);
+    }
+    deleteGraph(graph);
+    return 0;
+}
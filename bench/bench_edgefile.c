@@ -0,0 +1,81 @@
+/*
+ * Edge-list ingestion: an fscanf + newEdge/newEdgeList loop against
+ * readCSRGraphEdges and readGraphEdges on 1 to 16 threads.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_edgefile.c edgefile.c csr.c graph.c arena.c "minheap (1).c" -lpthread
+ * Usage: ./a.out [numVertices] [numEdges] [path]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "csr.h"
+#include "edgefile.h"
+
+int main(int argc, char** argv) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    int numEdges = argc > 2 ? atoi(argv[2]) : 10000000;
+    const char* path = argc > 3 ? argv[3] : "bench_edges.gr";
+    if (numVertices < 2 || numEdges < 0) {
+        fprintf(stderr, "usage: %s [numVertices >= 2] [numEdges >= 0] [path]\n", argv[0]);
+        return 1;
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    uint64_t state = 42;
+    fprintf(file, "c random graph\np sp %d %d\n", numVertices, numEdges);
+    for (int i = 0; i < numEdges; i++) {
+        int u = benchRandomRange(&state, 1, numVertices);
+        int v = benchRandomRange(&state, 1, numVertices);
+        fprintf(file, "a %d %d %d\n", u, v, benchRandomRange(&state, 1, 1000));
+    }
+    long bytes = ftell(file);
+    fclose(file);
+    double megabytes = bytes / 1e6;
+
+    // what ingestion code does without a loader
+    double start = benchNow();
+    file = fopen(path, "r");
+    Graph* graph = newGraph(numVertices);
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        int u, v, w;
+        if (sscanf(line, "a %d %d %d", &u, &v, &w) == 3) {
+            graph->vertices[u - 1]->adjList =
+                newEdgeList(newEdge(u - 1, v - 1, w), graph->vertices[u - 1]->adjList);
+            graph->numEdges++;
+        }
+    }
+    fclose(file);
+    double scanfTime = benchNow() - start;
+    deleteGraph(graph);
+
+    printf("%d vertices, %d edges, %.1f MB DIMACS file\n", numVertices, numEdges, megabytes);
+    printf("%-22s %10s %10s\n", "", "time (s)", "MB/s");
+    printf("%-22s %10.3f %10.1f\n", "fscanf + newEdge", scanfTime, megabytes / scanfTime);
+    for (int numThreads = 1; numThreads <= 16; numThreads *= 2) {
+        start = benchNow();
+        CSRGraph* csr = readCSRGraphEdges(path, EDGE_FORMAT_DIMACS, numThreads);
+        double csrTime = benchNow() - start;
+        start = benchNow();
+        graph = readGraphEdges(path, EDGE_FORMAT_DIMACS, numThreads);
+        double graphTime = benchNow() - start;
+        if (csr == NULL || graph == NULL) {
+            fprintf(stderr, "cannot read %s\n", path);
+            return 1;
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "CSR, %d threads", numThreads);
+        printf("%-22s %10.3f %10.1f\n", label, csrTime, megabytes / csrTime);
+        snprintf(label, sizeof(label), "Graph, %d threads", numThreads);
+        printf("%-22s %10.3f %10.1f\n", label, graphTime, megabytes / graphTime);
+        deleteCSRGraph(csr);
+        deleteGraph(graph);
+    }
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Specialized searches against the generic ones: each search.h function
+ * next to its graph_algos.c or csr.c counterpart, with a checksum of the
+ * results that must match within each group. Distance trees, MSTs and
+ * point-to-point paths run on a road-like grid with coordinates, and
+ * distance trees again on a directed R-MAT graph.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_engine.c search.c csr.c distance.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [gridSide] [rmatScale] [runs]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "csr.h"
+#include "search.h"
+
+typedef Edge* (*TreeSearch)(Graph* graph, int startVertex);
+typedef Edge* (*CSRTreeSearch)(CSRGraph* csr, int startVertex);
+typedef EdgeList* (*PathSearch)(Graph* graph, int startVertex, int targetVertex);
+
+static double admissibleScale;
+
+static Edge* dijkstraDary(Graph* graph, int startVertex) {
+    return getDistanceTreeDijkstraPQ(graph, startVertex, PQ_DARY_HEAP);
+}
+
+static Edge* primDary(Graph* graph, int startVertex) {
+    return getMSTprimPQ(graph, startVertex, PQ_DARY_HEAP);
+}
+
+static EdgeList* aStarGeneric(Graph* graph, int startVertex, int targetVertex) {
+    return getShortestPathAStar(graph, startVertex, targetVertex, euclideanHeuristic,
+                                &admissibleScale, NULL);
+}
+
+static EdgeList* aStarSpecialized(Graph* graph, int startVertex, int targetVertex) {
+    return searchShortestPathEuclidean(graph, startVertex, targetVertex, admissibleScale, NULL);
+}
+
+/*
+ * Sum of the weights of the first 'count' edges of 'tree'.
+ */
+static long treeChecksum(Edge* tree, int count) {
+    long checksum = 0;
+    for (int i = 0; i < count; i++) {
+        checksum += tree[i].weight;
+    }
+    return checksum;
+}
+
+static void printRow(const char* name, double elapsed, int runs, double baseline, long checksum) {
+    printf("  %-34s %10.3f %8.2fx %14ld\n", name, 1000 * elapsed / runs, baseline / elapsed,
+           checksum);
+}
+
+static double timeTrees(const char* name, TreeSearch search, Graph* graph, int* sources,
+                        int runs, int count, double baseline) {
+    long checksum = 0;
+    double start = benchNow();
+    for (int r = 0; r < runs; r++) {
+        Edge* tree = search(graph, sources[r]);
+        checksum += treeChecksum(tree, count);
+        free(tree);
+    }
+    double elapsed = benchNow() - start;
+    printRow(name, elapsed, runs, baseline > 0 ? baseline : elapsed, checksum);
+    return elapsed;
+}
+
+static double timeCSRTrees(const char* name, CSRTreeSearch search, CSRGraph* csr, int* sources,
+                           int runs, int count, double baseline) {
+    long checksum = 0;
+    double start = benchNow();
+    for (int r = 0; r < runs; r++) {
+        Edge* tree = search(csr, sources[r]);
+        checksum += treeChecksum(tree, count);
+        free(tree);
+    }
+    double elapsed = benchNow() - start;
+    printRow(name, elapsed, runs, baseline > 0 ? baseline : elapsed, checksum);
+    return elapsed;
+}
+
+static double timePaths(const char* name, PathSearch search, Graph* graph, int* sources,
+                        int* targets, int runs, double baseline) {
+    long checksum = 0;
+    double start = benchNow();
+    for (int r = 0; r < runs; r++) {
+        EdgeList* path = search(graph, sources[r], targets[r]);
+        checksum += benchPathWeight(path);
+        deleteEdgeList(path);
+    }
+    double elapsed = benchNow() - start;
+    printRow(name, elapsed, runs, baseline > 0 ? baseline : elapsed, checksum);
+    return elapsed;
+}
+
+/*
+ * Runs the distance tree group on 'graph', and if it is a connected
+ * undirected graph with coordinates, the MST and path groups as well.
+ */
+static void benchGraph(Graph* graph, int runs, bool isGrid) {
+    int n = graph->numVertices;
+    CSRGraph* csr = newCSRGraph(graph);
+    uint64_t state = 7;
+    int* sources = (int*)malloc(runs * sizeof(int));
+    int* targets = (int*)malloc(runs * sizeof(int));
+    for (int r = 0; r < runs; r++) {
+        sources[r] = benchRandomRange(&state, 0, n - 1);
+        targets[r] = benchRandomRange(&state, 0, n - 1);
+    }
+    printf("  %-34s %10s %9s %14s\n", "", "ms / run", "speedup", "checksum");
+
+    double baseline = timeTrees("getDistanceTreeDijkstra", getDistanceTreeDijkstra, graph,
+                                sources, runs, n, 0);
+    timeTrees("getDistanceTreeDijkstraPQ, d-ary", dijkstraDary, graph, sources, runs, n,
+              baseline);
+    timeTrees("searchDistanceTree", searchDistanceTree, graph, sources, runs, n, baseline);
+    timeCSRTrees("getDistanceTreeDijkstraCSR", getDistanceTreeDijkstraCSR, csr, sources, runs,
+                 n, baseline);
+    timeCSRTrees("searchDistanceTreeCSR", searchDistanceTreeCSR, csr, sources, runs, n,
+                 baseline);
+    if (!isGrid) {
+        free(sources);
+        free(targets);
+        deleteCSRGraph(csr);
+        return;
+    }
+
+    printf("\n");
+    baseline = timeTrees("getMSTprim", getMSTprim, graph, sources, runs, n - 1, 0);
+    timeTrees("getMSTprimPQ, d-ary", primDary, graph, sources, runs, n - 1, baseline);
+    timeTrees("searchMSTprim", searchMSTprim, graph, sources, runs, n - 1, baseline);
+    timeCSRTrees("getMSTprimCSR", getMSTprimCSR, csr, sources, runs, n - 1, baseline);
+    timeCSRTrees("searchMSTprimCSR", searchMSTprimCSR, csr, sources, runs, n - 1, baseline);
+
+    printf("\n");
+    baseline = timePaths("getShortestPath", getShortestPath, graph, sources, targets, runs, 0);
+    timePaths("searchShortestPath", searchShortestPath, graph, sources, targets, runs,
+              baseline);
+    timePaths("getShortestPathAStar, euclidean", aStarGeneric, graph, sources, targets, runs,
+              baseline);
+    timePaths("searchShortestPathEuclidean", aStarSpecialized, graph, sources, targets, runs,
+              baseline);
+    free(sources);
+    free(targets);
+    deleteCSRGraph(csr);
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 300;
+    int scale = argc > 2 ? atoi(argv[2]) : 16;
+    int runs = argc > 3 ? atoi(argv[3]) : 20;
+    if (side < 2 || scale < 2 || scale > 26 || runs < 1) {
+        fprintf(stderr, "usage: %s [gridSide >= 2] [2 <= rmatScale <= 26] [runs >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+
+    Graph* grid = benchGridGraph(side, side, 1000, 42);
+    for (int id = 0; id < grid->numVertices; id++) {
+        setVertexCoordinates(grid, id, id % side, id / side);
+    }
+    admissibleScale = getAdmissibleScale(grid, euclideanDistance);
+    printf("%dx%d grid, %d vertices, %d edges\n", side, side, grid->numVertices,
+           grid->numEdges);
+    benchGraph(grid, runs, true);
+    deleteGraph(grid);
+
+    Graph* rmat = benchRMATGraph(scale, 16, 1000, 42);
+    printf("\nR-MAT scale %d, %d vertices, %d edges\n", scale, rmat->numVertices,
+           rmat->numEdges);
+    benchGraph(rmat, runs, false);
+    deleteGraph(rmat);
+    return 0;
+}
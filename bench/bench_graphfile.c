@@ -0,0 +1,87 @@
+/*
+ * Startup time of a graph rebuilt edge by edge against the same graph
+ * mapped from a graph file, each followed by one shortest-path tree.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_graphfile.c graphfile.c csr.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [numVertices] [numEdges] [path]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "csr.h"
+#include "graphfile.h"
+
+int main(int argc, char** argv) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    int numEdges = argc > 2 ? atoi(argv[2]) : 5000000;
+    const char* path = argc > 3 ? argv[3] : "bench_graph.bin";
+    if (numVertices < 2 || numEdges < 0) {
+        fprintf(stderr, "usage: %s [numVertices >= 2] [numEdges >= 0] [path]\n", argv[0]);
+        return 1;
+    }
+    // the edges a text loader would parse, generated up front
+    Edge* edges = (Edge*)malloc((numEdges + 1) * sizeof(Edge));
+    if (edges == NULL) {
+        return 1;
+    }
+    uint64_t state = 42;
+    for (int i = 0; i < numEdges; i++) {
+        edges[i].fromVertex = benchRandomRange(&state, 0, numVertices - 1);
+        edges[i].toVertex = benchRandomRange(&state, 0, numVertices - 1);
+        edges[i].weight = benchRandomRange(&state, 1, 100);
+    }
+
+    double start = benchNow();
+    Graph* graph = newGraph(numVertices);
+    for (int i = 0; i < numEdges; i++) {
+        Vertex* vertex = graph->vertices[edges[i].fromVertex];
+        vertex->adjList = newEdgeList(newEdge(edges[i].fromVertex, edges[i].toVertex,
+                                              edges[i].weight), vertex->adjList);
+        graph->numEdges++;
+    }
+    CSRGraph* csr = newCSRGraph(graph);
+    double rebuild = benchNow() - start;
+    free(edges);
+
+    start = benchNow();
+    if (!writeGraphFile(graph, path, 0)) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    double write = benchNow() - start;
+
+    start = benchNow();
+    Edge* distTree = getDistanceTreeDijkstraCSR(csr, 0);
+    double rebuiltQuery = benchNow() - start;
+    free(distTree);
+    deleteCSRGraph(csr);
+    deleteGraph(graph);
+
+    start = benchNow();
+    MappedGraph* mapped = mapGraphFile(path);
+    double map = benchNow() - start;
+    if (mapped == NULL) {
+        fprintf(stderr, "cannot map %s\n", path);
+        return 1;
+    }
+    start = benchNow();
+    bool valid = verifyGraphFile(mapped);
+    double verify = benchNow() - start;
+    start = benchNow();
+    distTree = getDistanceTreeDijkstraCSR(&mapped->csr, 0);
+    double mappedQuery = benchNow() - start;
+    free(distTree);
+    size_t length = mapped->length;
+    unmapGraphFile(mapped);
+    remove(path);
+
+    printf("%d vertices, %d edges, %zu byte file (%s)\n", numVertices, numEdges, length,
+           valid ? "valid" : "INVALID");
+    printf("%-16s %12s %14s\n", "", "startup (s)", "first tree (s)");
+    printf("%-16s %12.3f %14.3f\n", "rebuild", rebuild, rebuiltQuery);
+    printf("%-16s %12.6f %14.3f\n", "mmap", map, mappedQuery);
+    printf("write %.3f s, verify %.3f s\n", write, verify);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Many-source distance matrix throughput of getDistanceMatrixParallel
+ * at 1, 2, 4, ... threads, checked against getDistanceTreeDijkstra.
+ *
+ * Build from the repository root:
+ *   cc -O2 -pthread -I. bench/bench_matrix.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [gridSide] [numSources] [maxThreads]
+ */
+
+#include "bench/bench_util.h"
+#include <limits.h>
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 200;
+    int numSources = argc > 2 ? atoi(argv[2]) : 256;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : 16;
+    if (side < 2 || numSources < 1 || maxThreads < 1) {
+        fprintf(stderr, "usage: %s [gridSide >= 2] [numSources >= 1] [maxThreads >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(side, side, 100, 42);
+    int n = graph->numVertices;
+    int* sources = (int*)malloc(numSources * sizeof(int));
+    int* matrix = (int*)malloc((size_t)numSources * n * sizeof(int));
+    if (sources == NULL || matrix == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    uint64_t state = 7;
+    for (int i = 0; i < numSources; i++) {
+        sources[i] = benchRandomRange(&state, 0, n - 1);
+    }
+    printf("grid %dx%d, %d vertices, %d edges, %d sources\n", side, side, n,
+           graph->numEdges, numSources);
+    printf("%8s %12s %14s %10s\n", "threads", "time (s)", "sources/s", "speedup");
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double start = benchNow();
+        getDistanceMatrixParallel(graph, sources, numSources, matrix, threads);
+        double elapsed = benchNow() - start;
+        if (threads == 1) {
+            baseline = elapsed;
+        }
+        printf("%8d %12.3f %14.1f %10.2f\n", threads, elapsed, numSources / elapsed,
+               baseline / elapsed);
+    }
+    // spot check a few rows against the sequential implementation
+    int mismatches = 0;
+    for (int i = 0; i < numSources && i < 4; i++) {
+        Edge* distTree = getDistanceTreeDijkstra(graph, sources[i]);
+        for (int v = 0; v < n; v++) {
+            if (distTree[v].weight != matrix[(size_t)i * n + v]) {
+                mismatches++;
+            }
+        }
+        free(distTree);
+    }
+    if (mismatches > 0) {
+        printf("WARNING: %d distances differ from getDistanceTreeDijkstra\n", mismatches);
+    }
+    free(sources);
+    free(matrix);
+    deleteGraph(graph);
+    return mismatches > 0;
+}
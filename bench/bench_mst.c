@@ -0,0 +1,102 @@
+/*
+ * MST engines on a sparse, a dense and a disconnected random graph:
+ * getMSTprim, getMinimumSpanningForest, Kruskal, Borůvka on 1 to 8
+ * threads, and the getMST selector.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_mst.c mst.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm -lpthread
+ * Usage: ./a.out [numVertices] [sparseDegree] [denseDegree]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "mst.h"
+
+static long treeWeight(Edge* tree, int numTreeEdges) {
+    long total = 0;
+    for (int i = 0; i < numTreeEdges; i++) {
+        total += tree[i].weight;
+    }
+    return total;
+}
+
+/*
+ * A random graph with 'degree' undirected edges per vertex, plus a path
+ * through every vertex if 'connected', so that getMSTprim spans it.
+ */
+static Graph* randomGraph(int numVertices, int degree, bool connected, uint64_t seed) {
+    Graph* graph = newGraph(numVertices);
+    uint64_t state = seed;
+    for (int v = 1; connected && v < numVertices; v++) {
+        benchAddUndirected(graph, v - 1, v, benchRandomRange(&state, 1, 1000000));
+    }
+    for (long i = 0; i < (long)numVertices * degree / 2; i++) {
+        benchAddUndirected(graph, benchRandomRange(&state, 0, numVertices - 1),
+                           benchRandomRange(&state, 0, numVertices - 1),
+                           benchRandomRange(&state, 1, 1000000));
+    }
+    return graph;
+}
+
+static void run(const char* label, Graph* graph) {
+    printf("%s: %d vertices, %d edges\n", label, graph->numVertices, graph->numEdges);
+    double start = benchNow();
+    Edge* tree = getMSTprim(graph, 0);
+    double elapsed = benchNow() - start;
+    // only meaningful on a connected graph, where the tree has n - 1 edges
+    printf("  %-16s %10.3f s  weight %ld\n", "Prim", elapsed,
+           treeWeight(tree, graph->numVertices - 1));
+    free(tree);
+
+    start = benchNow();
+    SpanningForest* forest = getMinimumSpanningForest(graph);
+    elapsed = benchNow() - start;
+    printf("  %-16s %10.3f s  weight %ld, %d components\n", "forest", elapsed,
+           treeWeight(forest->treeEdges, forest->numTreeEdges), forest->numComponents);
+    deleteSpanningForest(forest);
+
+    int count;
+    start = benchNow();
+    tree = getMSTKruskal(graph, &count);
+    elapsed = benchNow() - start;
+    printf("  %-16s %10.3f s  weight %ld\n", "Kruskal", elapsed, treeWeight(tree, count));
+    free(tree);
+
+    for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+        char name[32];
+        snprintf(name, sizeof(name), "Boruvka, %d", numThreads);
+        start = benchNow();
+        tree = getMSTBoruvka(graph, numThreads, &count);
+        elapsed = benchNow() - start;
+        printf("  %-16s %10.3f s  weight %ld\n", name, elapsed, treeWeight(tree, count));
+        free(tree);
+    }
+    start = benchNow();
+    tree = getMST(graph, 1, &count);
+    elapsed = benchNow() - start;
+    printf("  %-16s %10.3f s  weight %ld\n", "getMST, 1", elapsed, treeWeight(tree, count));
+    free(tree);
+}
+
+int main(int argc, char** argv) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 200000;
+    int sparseDegree = argc > 2 ? atoi(argv[2]) : 4;
+    int denseDegree = argc > 3 ? atoi(argv[3]) : 64;
+    if (numVertices < 2 || sparseDegree < 0 || denseDegree < 0) {
+        fprintf(stderr, "usage: %s [numVertices >= 2] [sparseDegree] [denseDegree]\n",
+                argv[0]);
+        return 1;
+    }
+    Graph* graph = randomGraph(numVertices, sparseDegree, true, 42);
+    run("sparse", graph);
+    deleteGraph(graph);
+    graph = randomGraph(numVertices / 4, denseDegree, true, 43);
+    run("dense", graph);
+    deleteGraph(graph);
+    graph = randomGraph(numVertices, 1, false, 44);
+    run("disconnected", graph);
+    deleteGraph(graph);
+    return 0;
+}
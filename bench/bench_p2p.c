@@ -0,0 +1,106 @@
+/*
+ * Point-to-point query latency: getShortestPath,
+ * getShortestPathBidirectional and getShortestPathCH against the full
+ * getDistanceTreeDijkstra + getShortestPaths approach.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_p2p.c graph.c graph_algos.c pq.c ch.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [gridSide] [numQueries]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "ch.h"
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 100;
+    int numQueries = argc > 2 ? atoi(argv[2]) : 100;
+    if (side < 2 || numQueries < 1) {
+        fprintf(stderr, "usage: %s [gridSide >= 2] [numQueries >= 1]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(side, side, 100, 42);
+    if (graph == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    int n = graph->numVertices;
+    double start = benchNow();
+    CHGraph* ch = newCHGraph(graph);
+    double chBuildTime = benchNow() - start;
+    if (ch == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    double* p2pTimes = (double*)malloc(numQueries * sizeof(double));
+    double* biTimes = (double*)malloc(numQueries * sizeof(double));
+    double* chTimes = (double*)malloc(numQueries * sizeof(double));
+    double* treeTimes = (double*)malloc(numQueries * sizeof(double));
+    uint64_t state = 7;
+    int mismatches = 0;
+    for (int q = 0; q < numQueries; q++) {
+        int s = benchRandomRange(&state, 0, n - 1);
+        int t = benchRandomRange(&state, 0, n - 1);
+
+        start = benchNow();
+        EdgeList* path = getShortestPath(graph, s, t);
+        p2pTimes[q] = benchNow() - start;
+
+        // the grid is undirected, so it is its own reverse graph
+        start = benchNow();
+        EdgeList* biPath = getShortestPathBidirectional(graph, NULL, s, t);
+        biTimes[q] = benchNow() - start;
+
+        start = benchNow();
+        EdgeList* chPath = getShortestPathCH(ch, s, t);
+        chTimes[q] = benchNow() - start;
+
+        start = benchNow();
+        Edge* distTree = getDistanceTreeDijkstra(graph, s);
+        EdgeList** paths = getShortestPaths(distTree, n, s);
+        treeTimes[q] = benchNow() - start;
+
+        if (benchPathWeight(path) != benchPathWeight(paths[t]) ||
+            benchPathWeight(biPath) != benchPathWeight(paths[t]) ||
+            benchPathWeight(chPath) != benchPathWeight(paths[t])) {
+            mismatches++;
+        }
+        deleteEdgeList(path);
+        deleteEdgeList(biPath);
+        deleteEdgeList(chPath);
+        for (int i = 0; i < n; i++) {
+            deleteEdgeList(paths[i]);
+        }
+        free(paths);
+        free(distTree);
+    }
+    printf("grid %dx%d, %d vertices, %d edges, %d queries\n", side, side, n,
+           graph->numEdges, numQueries);
+    printf("CH preprocessing: %.1f ms, %d shortcuts\n", 1e3 * chBuildTime,
+           ch->numShortcuts);
+    printf("%-30s %12s %12s\n", "", "p50 (ms)", "p99 (ms)");
+    printf("%-30s %12.3f %12.3f\n", "getShortestPath",
+           1e3 * benchPercentile(p2pTimes, numQueries, 50),
+           1e3 * benchPercentile(p2pTimes, numQueries, 99));
+    printf("%-30s %12.3f %12.3f\n", "getShortestPathBidirectional",
+           1e3 * benchPercentile(biTimes, numQueries, 50),
+           1e3 * benchPercentile(biTimes, numQueries, 99));
+    printf("%-30s %12.3f %12.3f\n", "getShortestPathCH",
+           1e3 * benchPercentile(chTimes, numQueries, 50),
+           1e3 * benchPercentile(chTimes, numQueries, 99));
+    printf("%-30s %12.3f %12.3f\n", "full tree + getShortestPaths",
+           1e3 * benchPercentile(treeTimes, numQueries, 50),
+           1e3 * benchPercentile(treeTimes, numQueries, 99));
+    if (mismatches > 0) {
+        printf("WARNING: %d path weights differ\n", mismatches);
+    }
+    free(p2pTimes);
+    free(biTimes);
+    free(chTimes);
+    free(treeTimes);
+    deleteCHGraph(ch);
+    deleteGraph(graph);
+    return mismatches > 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Path output on a chain, where paths are long: getShortestPaths against
+ * a ShortestPathTree with every path walked by fillTreePath and by a
+ * PathIterator. getShortestPaths holds every path at once, about n^2 / 2
+ * edges on a chain of n vertices, so keep numVertices to a few thousand.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_paths.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [numVertices]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+
+int main(int argc, char** argv) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 3000;
+    if (numVertices < 2) {
+        fprintf(stderr, "usage: %s [numVertices >= 2]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(1, numVertices, 100, 42);
+
+    double start = benchNow();
+    Edge* distTree = getDistanceTreeDijkstraPQ(graph, 0, PQ_DARY_HEAP);
+    double search = benchNow() - start;
+    start = benchNow();
+    EdgeList** paths = getShortestPaths(distTree, numVertices, 0);
+    double build = benchNow() - start;
+    long total = 0;
+    for (int v = 0; v < numVertices; v++) {
+        total += benchPathWeight(paths[v]) > 0 ? benchPathWeight(paths[v]) : 0;
+        deleteEdgeList(paths[v]);
+    }
+    free(paths);
+    free(distTree);
+
+    start = benchNow();
+    ShortestPathTree* tree = getShortestPathTree(graph, 0);
+    double treeSearch = benchNow() - start;
+    Edge* buffer = (Edge*)malloc(numVertices * sizeof(Edge));
+    long fillTotal = 0;
+    start = benchNow();
+    for (int v = 0; v < numVertices; v++) {
+        int length = fillTreePath(tree, v, buffer, numVertices);
+        for (int i = 0; i < length; i++) {
+            fillTotal += buffer[i].weight;
+        }
+    }
+    double fill = benchNow() - start;
+    long iterTotal = 0;
+    start = benchNow();
+    for (int v = 0; v < numVertices; v++) {
+        PathIterator iterator;
+        Edge edge;
+        initPathIterator(&iterator, tree, v);
+        while (nextPathEdge(&iterator, &edge)) {
+            iterTotal += edge.weight;
+        }
+    }
+    double iterate = benchNow() - start;
+    free(buffer);
+    deleteShortestPathTree(tree);
+    deleteGraph(graph);
+
+    printf("chain of %d vertices, total path weight %ld / %ld / %ld\n", numVertices, total,
+           fillTotal, iterTotal);
+    printf("%-28s %10s %10s\n", "", "search (s)", "paths (s)");
+    printf("%-28s %10.4f %10.4f\n", "getShortestPaths", search, build);
+    printf("%-28s %10.4f %10.4f\n", "tree + fillTreePath", treeSearch, fill);
+    printf("%-28s %10.4f %10.4f\n", "tree + PathIterator", treeSearch, iterate);
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Relaxation kernels: edges per second of relaxCandidates with every
+ * kernel the CPU supports, per vertex degree, on random targets in a
+ * distance array larger than the caches; then getDistanceTreeDijkstraCSR
+ * against getDistanceTreeDijkstraVector on an R-MAT graph, whose hubs
+ * are where the wide kernels pay off.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_relax.c relax.c csr.c graph.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rmatScale] [edgeFactor] [runs]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "csr.h"
+#include "relax.h"
+
+#define NUM_DISTANCES (1 << 22)
+#define EDGES_PER_BUCKET (1 << 24)
+
+static void benchKernels(void) {
+    int degrees[9] = {4, 8, 16, 32, 64, 128, 256, 1024, 4096};
+    int maxDegree = degrees[8];
+    uint64_t state = 5;
+    int* distances = (int*)malloc(NUM_DISTANCES * sizeof(int));
+    for (int i = 0; i < NUM_DISTANCES; i++) {
+        distances[i] = benchRandomRange(&state, 0, 1 << 21);
+    }
+    // one block of edges per source vertex, as in a CSR graph
+    int numBlocks = EDGES_PER_BUCKET / maxDegree;
+    int* targets = (int*)malloc(EDGES_PER_BUCKET * sizeof(int));
+    int* weights = (int*)malloc(EDGES_PER_BUCKET * sizeof(int));
+    int* improved = (int*)malloc(maxDegree * sizeof(int));
+    for (int i = 0; i < EDGES_PER_BUCKET; i++) {
+        targets[i] = benchRandomRange(&state, 0, NUM_DISTANCES - 1);
+        weights[i] = benchRandomRange(&state, 1, 1 << 16);
+    }
+    printf("%8s", "degree");
+    for (int k = RELAX_SCALAR; k <= RELAX_AVX512; k++) {
+        if (hasRelaxKernel((RelaxKernel)k)) {
+            printf(" %14s", relaxKernelName((RelaxKernel)k));
+        }
+    }
+    printf("   (million edges/s, about half improve)\n");
+    for (int d = 0; d < 9; d++) {
+        int degree = degrees[d];
+        printf("%8d", degree);
+        for (int k = RELAX_SCALAR; k <= RELAX_AVX512; k++) {
+            if (!hasRelaxKernel((RelaxKernel)k)) {
+                continue;
+            }
+            long total = 0;
+            double start = benchNow();
+            for (int pass = 0; pass < maxDegree / degree; pass++) {
+                for (int b = 0; b < numBlocks; b++) {
+                    int first = b * maxDegree + pass * degree;
+                    total += relaxCandidates((RelaxKernel)k, targets + first, weights + first,
+                                             degree, 1 << 20, distances, improved);
+                }
+            }
+            double elapsed = benchNow() - start;
+            printf(" %14.1f", EDGES_PER_BUCKET / elapsed / 1e6);
+            if (total < 0) {
+                printf("?");  // keeps the calls from being optimized away
+            }
+        }
+        printf("\n");
+    }
+    free(distances);
+    free(targets);
+    free(weights);
+    free(improved);
+}
+
+static void benchDijkstra(int scale, int edgeFactor, int runs) {
+    Graph* graph = benchRMATGraph(scale, edgeFactor, 1000, 42);
+    CSRGraph* csr = newCSRGraph(graph);
+    deleteGraph(graph);
+    int n = csr->numVertices;
+    printf("\nR-MAT scale %d, %d vertices, %d edges\n", scale, n, csr->numEdges);
+    printf("%-28s %12s %10s\n", "", "ms / search", "correct");
+    uint64_t state = 7;
+    int* sources = (int*)malloc(runs * sizeof(int));
+    Edge** expected = (Edge**)malloc(runs * sizeof(Edge*));
+    double start = benchNow();
+    for (int r = 0; r < runs; r++) {
+        sources[r] = benchRandomRange(&state, 0, n - 1);
+        expected[r] = getDistanceTreeDijkstraCSR(csr, sources[r]);
+    }
+    printf("%-28s %12.2f %10s\n", "getDistanceTreeDijkstraCSR",
+           1000 * (benchNow() - start) / runs, "-");
+    for (int k = RELAX_SCALAR; k <= RELAX_AVX512; k++) {
+        if (!hasRelaxKernel((RelaxKernel)k)) {
+            continue;
+        }
+        bool correct = true;
+        double elapsed = 0;
+        for (int r = 0; r < runs; r++) {
+            start = benchNow();
+            Edge* distTree = getDistanceTreeDijkstraVector(csr, sources[r], (RelaxKernel)k);
+            elapsed += benchNow() - start;
+            for (int v = 0; v < n; v++) {
+                correct = correct && distTree[v].weight == expected[r][v].weight;
+            }
+            free(distTree);
+        }
+        char name[40];
+        snprintf(name, sizeof(name), "vector, %s", relaxKernelName((RelaxKernel)k));
+        printf("%-28s %12.2f %10s\n", name, 1000 * elapsed / runs, correct ? "yes" : "NO");
+    }
+    for (int r = 0; r < runs; r++) {
+        free(expected[r]);
+    }
+    free(expected);
+    free(sources);
+    deleteCSRGraph(csr);
+}
+
+int main(int argc, char** argv) {
+    int scale = argc > 1 ? atoi(argv[1]) : 18;
+    int edgeFactor = argc > 2 ? atoi(argv[2]) : 16;
+    int runs = argc > 3 ? atoi(argv[3]) : 5;
+    if (scale < 2 || scale > 26 || edgeFactor < 1 || runs < 1) {
+        fprintf(stderr, "usage: %s [2 <= rmatScale <= 26] [edgeFactor >= 1] [runs >= 1]\n",
+                argv[0]);
+        return 1;
+    }
+    benchKernels();
+    benchDijkstra(scale, edgeFactor, runs);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Dijkstra on a grid whose ids and allocation order have been shuffled,
+ * as they are when read from a file that lists vertices arbitrarily,
+ * against the same graph after each reordering. "identity" keeps the
+ * shuffled ids but rebuilds the graph in an arena, which separates the
+ * gain from compact adjacency lists from that of the new ids.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_reorder.c reorder.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rows] [cols] [runs]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include <string.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "reorder.h"
+
+/*
+ * Returns a 'rows' x 'cols' grid with random ids, coordinates set to the
+ * grid position, and its edges allocated in random order.
+ */
+static Graph* shuffledGrid(int rows, int cols, uint64_t* state) {
+    int n = rows * cols;
+    int* ids = (int*)malloc(n * sizeof(int));
+    Edge* edges = (Edge*)malloc(2 * n * sizeof(Edge));
+    Graph* graph = newGraph(n);
+    for (int i = 0; i < n; i++) {
+        ids[i] = i;
+    }
+    for (int i = n - 1; i > 0; i--) {
+        int j = benchRandomRange(state, 0, i);
+        int t = ids[i];
+        ids[i] = ids[j];
+        ids[j] = t;
+    }
+    int numEdges = 0;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = ids[r * cols + c];
+            setVertexCoordinates(graph, u, c, r);
+            if (c + 1 < cols) {
+                edges[numEdges++] = (Edge){u, ids[r * cols + c + 1], benchRandomRange(state, 1, 1000)};
+            }
+            if (r + 1 < rows) {
+                edges[numEdges++] = (Edge){u, ids[(r + 1) * cols + c], benchRandomRange(state, 1, 1000)};
+            }
+        }
+    }
+    for (int i = numEdges - 1; i > 0; i--) {
+        int j = benchRandomRange(state, 0, i);
+        Edge t = edges[i];
+        edges[i] = edges[j];
+        edges[j] = t;
+    }
+    for (int i = 0; i < numEdges; i++) {
+        benchAddUndirected(graph, edges[i].fromVertex, edges[i].toVertex, edges[i].weight);
+    }
+    free(ids);
+    free(edges);
+    return graph;
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? atoi(argv[1]) : 1000;
+    int cols = argc > 2 ? atoi(argv[2]) : 1000;
+    int runs = argc > 3 ? atoi(argv[3]) : 5;
+    if (rows < 1 || cols < 2 || runs < 1) {
+        fprintf(stderr, "usage: %s [rows >= 1] [cols >= 2] [runs >= 1]\n", argv[0]);
+        return 1;
+    }
+    uint64_t state = 42;
+    Graph* graph = shuffledGrid(rows, cols, &state);
+    int n = graph->numVertices;
+    int* sources = (int*)malloc(runs * sizeof(int));
+    for (int r = 0; r < runs; r++) {
+        sources[r] = benchRandomRange(&state, 0, n - 1);
+    }
+    printf("%dx%d shuffled grid, %d vertices\n", rows, cols, n);
+    printf("%-10s %12s %16s %10s\n", "order", "reorder (s)", "ms / search", "checksum");
+
+    double start = benchNow();
+    long checksum = 0;
+    for (int r = 0; r < runs; r++) {
+        Edge* distTree = getDistanceTreeDijkstra(graph, sources[r]);
+        checksum += distTree[sources[(r + 1) % runs]].weight;
+        free(distTree);
+    }
+    printf("%-10s %12s %16.2f %10ld\n", "none", "-", 1000 * (benchNow() - start) / runs, checksum);
+
+    const char* names[5] = {"identity", "bfs", "rcm", "degree", "hilbert"};
+    for (int o = -1; o <= ORDER_HILBERT; o++) {
+        start = benchNow();
+        ReorderedGraph* reordered;
+        if (o == -1) {
+            int* identity = (int*)malloc(n * sizeof(int));
+            for (int i = 0; i < n; i++) {
+                identity[i] = i;
+            }
+            reordered = (ReorderedGraph*)calloc(1, sizeof(ReorderedGraph));
+            reordered->graph = permuteGraph(graph, identity, 0);
+            reordered->newIds = identity;
+            reordered->oldIds = (int*)malloc(n * sizeof(int));
+            memcpy(reordered->oldIds, identity, n * sizeof(int));
+        } else {
+            reordered = reorderGraph(graph, (VertexOrder)o, sizeof(Coordinates));
+        }
+        double build = benchNow() - start;
+        start = benchNow();
+        checksum = 0;
+        for (int r = 0; r < runs; r++) {
+            Edge* distTree = getDistanceTreeReordered(reordered, sources[r]);
+            checksum += distTree[sources[(r + 1) % runs]].weight;
+            free(distTree);
+        }
+        printf("%-10s %12.3f %16.2f %10ld\n", names[o + 1], build,
+               1000 * (benchNow() - start) / runs, checksum);
+        deleteReorderedGraph(reordered);
+    }
+    free(sources);
+    deleteGraph(graph);
+    return 0;
+}
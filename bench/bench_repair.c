@@ -0,0 +1,71 @@
+/*
+ * Incremental repair against recomputation: batches of random edge
+ * reweights on a grid, each followed by repairShortestPathTree and by a
+ * full getShortestPathTree.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_repair.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rows] [cols] [rounds]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? atoi(argv[1]) : 300;
+    int cols = argc > 2 ? atoi(argv[2]) : 300;
+    int rounds = argc > 3 ? atoi(argv[3]) : 20;
+    if (rows < 1 || cols < 2 || rounds < 1) {
+        fprintf(stderr, "usage: %s [rows >= 1] [cols >= 2] [rounds >= 1]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(rows, cols, 100, 42);
+    int n = graph->numVertices;
+    ShortestPathTree* tree = getShortestPathTree(graph, 0);
+    uint64_t state = 7;
+    printf("%dx%d grid, %d vertices\n", rows, cols, n);
+    printf("%-8s %14s %14s %12s %10s\n", "batch", "repair (ms)", "full (ms)", "touched",
+           "correct");
+    int batches[3] = {1, 10, 100};
+    for (int b = 0; b < 3; b++) {
+        int batch = batches[b];
+        Edge* changes = (Edge*)malloc(2 * batch * sizeof(Edge));
+        double repairTime = 0;
+        double fullTime = 0;
+        long touched = 0;
+        bool correct = true;
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < batch; i++) {
+                // reweight both directions of a random grid edge
+                int u = benchRandomRange(&state, 0, n - 1);
+                EdgeList* adj = graph->vertices[u]->adjList;
+                int v = adj->edge->toVertex;
+                int weight = benchRandomRange(&state, 1, 100);
+                setEdgeWeight(graph, u, v, weight);
+                setEdgeWeight(graph, v, u, weight);
+                changes[2 * i].fromVertex = u;
+                changes[2 * i].toVertex = v;
+                changes[2 * i + 1].fromVertex = v;
+                changes[2 * i + 1].toVertex = u;
+            }
+            double start = benchNow();
+            touched += repairShortestPathTree(graph, NULL, tree, changes, 2 * batch);
+            repairTime += benchNow() - start;
+            start = benchNow();
+            ShortestPathTree* full = getShortestPathTree(graph, 0);
+            fullTime += benchNow() - start;
+            for (int v = 0; v < n; v++) {
+                correct = correct && full->distances[v] == tree->distances[v];
+            }
+            deleteShortestPathTree(full);
+        }
+        printf("%-8d %14.3f %14.3f %12ld %10s\n", batch, 1000 * repairTime / rounds,
+               1000 * fullTime / rounds, touched / rounds, correct ? "yes" : "NO");
+        free(changes);
+    }
+    deleteShortestPathTree(tree);
+    deleteGraph(graph);
+    return 0;
+}
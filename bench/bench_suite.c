@@ -0,0 +1,313 @@
+/*
+ * Regression suite: graph construction, getDistanceTreeDijkstra,
+ * getShortestPaths and getMSTprim on grid, Erdős–Rényi, R-MAT and chain
+ * graphs of 2^scale vertices, and the MinHeap primitives. Prints one JSON
+ * document with the mean wall time per run, throughput, peak RSS and
+ * allocation counts of every benchmark, so that results can be kept and
+ * diffed from release to release.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_suite.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * To count allocations too (GNU ld), add
+ *   -DBENCH_COUNT_ALLOCS -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+ * Usage: ./a.out [scale] [runs] > results.json
+ */
+
+// for getrusage; bench_util.h only asks for clock_gettime
+#define _DEFAULT_SOURCE
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "minheap.h"
+
+/*********************************************************************
+ ** Measurement
+ *********************************************************************/
+
+#ifdef BENCH_COUNT_ALLOCS
+static long allocationCount = 0;
+static long freeCount = 0;
+
+// the linker sends every malloc, calloc, realloc and free here
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void __real_free(void* pointer);
+
+void* __wrap_malloc(size_t size) {
+    allocationCount++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocationCount++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocationCount++;
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void* pointer) {
+    freeCount += pointer != NULL;
+    __real_free(pointer);
+}
+#endif
+
+/*
+ * Resets the peak RSS to the current RSS where the kernel allows it
+ * (Linux), so that each benchmark reports its own peak rather than the
+ * process-wide one.
+ */
+static void resetPeakRSS(void) {
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file != NULL) {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+/*
+ * Returns the peak RSS in KiB: VmHWM if /proc is there, which
+ * resetPeakRSS can lower, and the process-wide ru_maxrss otherwise.
+ */
+static long getPeakRSS(void) {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file != NULL) {
+        char line[256];
+        long peak = -1;
+        while (peak < 0 && fgets(line, sizeof(line), file) != NULL) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                peak = atol(line + 6);
+            }
+        }
+        fclose(file);
+        if (peak >= 0) {
+            return peak;
+        }
+    }
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+}
+
+/*
+ * One benchmark in progress: started by beginMeasure and printed as a
+ * JSON object by endMeasure. Setup work between pauseMeasure and
+ * resumeMeasure counts neither towards the time nor the allocations.
+ */
+typedef struct measure
+{
+  const char* benchmark;
+  const char* graphName;  // NULL for benchmarks that take no graph
+  double start;           // since the last resume
+  double elapsed;         // up to the last pause
+  long allocationsStart;  // counters at the last resume
+  long freesStart;
+  long allocations;       // up to the last pause
+  long frees;
+} Measure;
+
+static bool firstResult = true;
+
+static void resumeMeasure(Measure* measure) {
+#ifdef BENCH_COUNT_ALLOCS
+    measure->allocationsStart = allocationCount;
+    measure->freesStart = freeCount;
+#endif
+    measure->start = benchNow();
+}
+
+static void pauseMeasure(Measure* measure) {
+    measure->elapsed += benchNow() - measure->start;
+#ifdef BENCH_COUNT_ALLOCS
+    measure->allocations += allocationCount - measure->allocationsStart;
+    measure->frees += freeCount - measure->freesStart;
+#endif
+}
+
+static void beginMeasure(Measure* measure, const char* benchmark, const char* graphName) {
+    measure->benchmark = benchmark;
+    measure->graphName = graphName;
+    measure->elapsed = 0;
+    measure->allocations = 0;
+    measure->frees = 0;
+    resetPeakRSS();
+    resumeMeasure(measure);
+}
+
+/*
+ * Prints the result of 'measure' over 'runs' runs that did 'work' units
+ * of work ('unit' per second is the throughput) on 'graph', if any.
+ */
+static void endMeasure(Measure* measure, Graph* graph, int runs, double work,
+                       const char* unit) {
+    pauseMeasure(measure);
+    double seconds = measure->elapsed;
+    long peak = getPeakRSS();
+    printf("%s\n    {\"benchmark\": \"%s\", ", firstResult ? "" : ",", measure->benchmark);
+    firstResult = false;
+    if (measure->graphName != NULL) {
+        printf("\"graph\": \"%s\", \"vertices\": %d, \"edges\": %d, ", measure->graphName,
+               graph->numVertices, graph->numEdges);
+    }
+    printf("\"runs\": %d, \"seconds\": %.6f, \"throughput\": %.1f, \"unit\": \"%s/s\", "
+           "\"peakRSSKiB\": %ld, ",
+           runs, seconds / runs, seconds > 0 ? work / seconds : 0.0, unit, peak);
+#ifdef BENCH_COUNT_ALLOCS
+    printf("\"allocations\": %ld, \"frees\": %ld}", measure->allocations / runs,
+           measure->frees / runs);
+#else
+    printf("\"allocations\": null, \"frees\": null}");
+#endif
+}
+
+/*********************************************************************
+ ** Benchmarks
+ *********************************************************************/
+
+typedef enum graphKind { GRID, ERDOS_RENYI, RMAT, CHAIN } GraphKind;
+
+static const char* graphNames[4] = {"grid", "erdos-renyi", "rmat", "chain"};
+
+static Graph* generate(GraphKind kind, int scale, uint64_t seed) {
+    switch (kind) {
+    case GRID:
+        return benchGridGraph(1 << (scale / 2), 1 << (scale - scale / 2), 1000, seed);
+    case ERDOS_RENYI:
+        return benchErdosRenyiGraph(1 << scale, 8, 1000, seed);
+    case RMAT:
+        return benchRMATGraph(scale, 8, 1000, seed);
+    default:
+        return benchChainGraph(1 << scale, 1000, seed);
+    }
+}
+
+/*
+ * Returns a random vertex with at least one outgoing edge, so that the
+ * isolated vertices of R-MAT graphs do not make for empty searches.
+ */
+static int randomSource(Graph* graph, uint64_t* state) {
+    for (int tries = 0; tries < 100; tries++) {
+        int v = benchRandomRange(state, 0, graph->numVertices - 1);
+        if (graph->vertices[v]->adjList != NULL) {
+            return v;
+        }
+    }
+    return 0;
+}
+
+static void benchGraph(GraphKind kind, int scale, int runs) {
+    const char* name = graphNames[kind];
+    Measure measure;
+    beginMeasure(&measure, "newGraph", name);
+    Graph* graph = generate(kind, scale, 42);
+    endMeasure(&measure, graph, 1, graph->numEdges, "edges");
+
+    uint64_t state = 7;
+    beginMeasure(&measure, "getDistanceTreeDijkstra", name);
+    for (int r = 0; r < runs; r++) {
+        free(getDistanceTreeDijkstra(graph, randomSource(graph, &state)));
+    }
+    endMeasure(&measure, graph, runs, (double)graph->numEdges * runs, "edges");
+
+    // every path is a copy, so a chain has quadratic output: leave it out
+    if (kind != CHAIN) {
+        int source = randomSource(graph, &state);
+        Edge* distTree = getDistanceTreeDijkstra(graph, source);
+        long pathEdges = 0;
+        beginMeasure(&measure, "getShortestPaths", name);
+        for (int r = 0; r < runs; r++) {
+            EdgeList** paths = getShortestPaths(distTree, graph->numVertices, source);
+            for (int v = 0; v < graph->numVertices; v++) {
+                for (EdgeList* node = paths[v]; node != NULL; node = node->next) {
+                    pathEdges++;
+                }
+                deleteEdgeList(paths[v]);
+            }
+            free(paths);
+        }
+        endMeasure(&measure, graph, runs, pathEdges, "path edges");
+        free(distTree);
+    }
+
+    beginMeasure(&measure, "getMSTprim", name);
+    for (int r = 0; r < runs; r++) {
+        free(getMSTprim(graph, randomSource(graph, &state)));
+    }
+    endMeasure(&measure, graph, runs, (double)graph->numEdges * runs, "edges");
+    deleteGraph(graph);
+}
+
+/*
+ * insert, decreasePriority and extractMin on their own, each over
+ * 2^scale ids with random priorities; filling or emptying the heap for
+ * the other two is left out of the measure.
+ */
+static void benchHeap(int scale, int runs) {
+    int n = 1 << scale;
+    int* priorities = (int*)malloc(n * sizeof(int));
+    uint64_t state = 11;
+    for (int i = 0; i < n; i++) {
+        priorities[i] = benchRandomRange(&state, 1 << 20, 1 << 30);
+    }
+    Measure inserts;
+    Measure decreases;
+    Measure extracts;
+    beginMeasure(&inserts, "MinHeap.insert", NULL);
+    pauseMeasure(&inserts);
+    beginMeasure(&decreases, "MinHeap.decreasePriority", NULL);
+    pauseMeasure(&decreases);
+    beginMeasure(&extracts, "MinHeap.extractMin", NULL);
+    pauseMeasure(&extracts);
+    long checksum = 0;
+    for (int r = 0; r < runs; r++) {
+        MinHeap* heap = newHeap(n);
+        resumeMeasure(&inserts);
+        for (int i = 0; i < n; i++) {
+            insert(heap, priorities[i], i);
+        }
+        pauseMeasure(&inserts);
+        resumeMeasure(&decreases);
+        for (int i = 0; i < n; i++) {
+            decreasePriority(heap, i, priorities[i] >> 1);
+        }
+        pauseMeasure(&decreases);
+        resumeMeasure(&extracts);
+        for (int i = 0; i < n; i++) {
+            checksum += extractMin(heap).id;
+        }
+        pauseMeasure(&extracts);
+        deleteHeap(heap);
+    }
+    // endMeasure pauses, so resume each first; the peak RSS is shared
+    resumeMeasure(&inserts);
+    endMeasure(&inserts, NULL, runs, (double)n * runs, "ops");
+    resumeMeasure(&decreases);
+    endMeasure(&decreases, NULL, runs, (double)n * runs, "ops");
+    resumeMeasure(&extracts);
+    endMeasure(&extracts, NULL, runs, (double)n * runs, "ops");
+    free(priorities);
+    if (checksum != (long)runs * n * (n - 1) / 2) {
+        fprintf(stderr, "MinHeap.extractMin returned the wrong ids\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    int scale = argc > 1 ? atoi(argv[1]) : 16;
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+    if (scale < 2 || scale > 26 || runs < 1) {
+        fprintf(stderr, "usage: %s [2 <= scale <= 26] [runs >= 1]\n", argv[0]);
+        return 1;
+    }
+    printf("{\n  \"scale\": %d,\n  \"runs\": %d,\n  \"results\": [", scale, runs);
+    for (int kind = GRID; kind <= CHAIN; kind++) {
+        benchGraph((GraphKind)kind, scale, runs);
+    }
+    benchHeap(scale, runs);
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Many-to-many distance tables on a grid: one getDistanceTreeDijkstra per
+ * source against getDistanceTable and getDistanceTableCH, in tables per
+ * second, at 100x100, 500x5000 and 1000x1000.
+ *
+ * Build from the repository root:
+ *   cc -O2 -I. bench/bench_table.c ch.c graph.c graph_algos.c pq.c arena.c "minheap (1).c" -lm
+ * Usage: ./a.out [rows] [cols]
+ */
+
+#include "bench/bench_util.h"
+#include <stdio.h>
+#include "graph.h"
+#include "graph_algos.h"
+#include "ch.h"
+
+static void randomVertices(int* ids, int count, int numVertices, uint64_t* state) {
+    for (int i = 0; i < count; i++) {
+        ids[i] = benchRandomRange(state, 0, numVertices - 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    int rows = argc > 1 ? atoi(argv[1]) : 100;
+    int cols = argc > 2 ? atoi(argv[2]) : 100;
+    if (rows < 1 || cols < 2) {
+        fprintf(stderr, "usage: %s [rows >= 1] [cols >= 2]\n", argv[0]);
+        return 1;
+    }
+    Graph* graph = benchGridGraph(rows, cols, 100, 42);
+    int n = graph->numVertices;
+    double start = benchNow();
+    CHGraph* ch = newCHGraph(graph);
+    double preprocessing = benchNow() - start;
+    printf("%dx%d grid, %d vertices, CH preprocessing %.2f s\n", rows, cols, n,
+           preprocessing);
+    printf("%-12s %14s %14s %14s\n", "size", "trees/s", "pruned/s", "CH/s");
+
+    int sizes[3][2] = {{100, 100}, {500, 5000}, {1000, 1000}};
+    uint64_t state = 7;
+    for (int s = 0; s < 3; s++) {
+        int numSources = sizes[s][0];
+        int numTargets = sizes[s][1];
+        int* sources = (int*)malloc(numSources * sizeof(int));
+        int* targets = (int*)malloc(numTargets * sizeof(int));
+        int64_t* pruned = (int64_t*)malloc((size_t)numSources * numTargets * sizeof(int64_t));
+        int64_t* bucketed = (int64_t*)malloc((size_t)numSources * numTargets * sizeof(int64_t));
+        randomVertices(sources, numSources, n, &state);
+        randomVertices(targets, numTargets, n, &state);
+
+        // what callers do today: a full tree per source
+        start = benchNow();
+        long checksum = 0;
+        for (int i = 0; i < numSources; i++) {
+            Edge* distTree = getDistanceTreeDijkstra(graph, sources[i]);
+            for (int j = 0; j < numTargets; j++) {
+                checksum += distTree[targets[j]].weight;
+            }
+            free(distTree);
+        }
+        double trees = benchNow() - start;
+
+        start = benchNow();
+        getDistanceTable(graph, sources, numSources, targets, numTargets, pruned);
+        double prunedTime = benchNow() - start;
+        start = benchNow();
+        getDistanceTableCH(ch, sources, numSources, targets, numTargets, bucketed);
+        double chTime = benchNow() - start;
+
+        long prunedSum = 0;
+        int mismatches = 0;
+        for (long e = 0; e < (long)numSources * numTargets; e++) {
+            prunedSum += pruned[e];
+            mismatches += pruned[e] != bucketed[e];
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%dx%d", numSources, numTargets);
+        printf("%-12s %14.2f %14.2f %14.2f%s\n", label, 1 / trees, 1 / prunedTime,
+               1 / chTime, checksum == prunedSum && mismatches == 0 ? "" : "  MISMATCH");
+        free(sources);
+        free(targets);
+        free(pruned);
+        free(bucketed);
+    }
+    deleteCHGraph(ch);
+    deleteGraph(graph);
+    return 0;
+}
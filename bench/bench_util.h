@@ -0,0 +1,187 @@
+/*
+ * Small helpers shared by the benchmark drivers: timing, a fixed seed
+ * random number generator, percentiles and synthetic graphs (road-like
+ * grids, Erdős–Rényi, R-MAT and chains).
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+// for clock_gettime; include this header before any system header
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+
+/*
+ * Returns a monotonic timestamp in seconds.
+ */
+static inline double benchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * xorshift64*: cheap, reproducible across platforms unlike rand().
+ */
+static inline uint64_t benchRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+ * Returns a random integer in lo..hi inclusive.
+ */
+static inline int benchRandomRange(uint64_t* state, int lo, int hi) {
+    return lo + (int)(benchRandom(state) % (uint64_t)(hi - lo + 1));
+}
+
+static int benchCompareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Returns the 'p'-th percentile (0..100) of the 'n' samples, which are
+ * sorted in place.
+ */
+static inline double benchPercentile(double* samples, int n, double p) {
+    if (n <= 0) {
+        return 0.0;
+    }
+    qsort(samples, n, sizeof(double), benchCompareDouble);
+    int index = (int)(p / 100.0 * (n - 1) + 0.5);
+    return samples[index];
+}
+
+/*
+ * Adds the undirected edge u -- v of weight 'weight' to 'graph'.
+ */
+static inline void benchAddUndirected(Graph* graph, int u, int v, int weight) {
+    graph->vertices[u]->adjList =
+        newEdgeList(newEdge(u, v, weight), graph->vertices[u]->adjList);
+    graph->vertices[v]->adjList =
+        newEdgeList(newEdge(v, u, weight), graph->vertices[v]->adjList);
+    graph->numEdges += 2;
+}
+
+/*
+ * Returns a 'rows' x 'cols' grid graph with undirected edges between
+ * horizontal and vertical neighbours, weights in 1..maxWeight. Vertex
+ * r * cols + c is the cell in row r and column c.
+ */
+static inline Graph* benchGridGraph(int rows, int cols, int maxWeight, uint64_t seed) {
+    Graph* graph = newGraph(rows * cols);
+    if (graph == NULL) {
+        return NULL;
+    }
+    uint64_t state = seed | 1;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            if (c + 1 < cols) {
+                benchAddUndirected(graph, u, u + 1, benchRandomRange(&state, 1, maxWeight));
+            }
+            if (r + 1 < rows) {
+                benchAddUndirected(graph, u, u + cols, benchRandomRange(&state, 1, maxWeight));
+            }
+        }
+    }
+    return graph;
+}
+
+/*
+ * Returns an Erdős–Rényi G(n, m) graph: 'numVertices' vertices and
+ * numVertices * degree / 2 undirected edges between uniformly random
+ * distinct endpoints, weights in 1..maxWeight.
+ */
+static inline Graph* benchErdosRenyiGraph(int numVertices, int degree, int maxWeight,
+                                          uint64_t seed) {
+    Graph* graph = newGraph(numVertices);
+    if (graph == NULL || numVertices < 2) {
+        return graph;
+    }
+    uint64_t state = seed | 1;
+    long numUndirected = (long)numVertices * degree / 2;
+    for (long i = 0; i < numUndirected; i++) {
+        int u = benchRandomRange(&state, 0, numVertices - 1);
+        int v = benchRandomRange(&state, 0, numVertices - 2);
+        v += v >= u;  // skip the self-loop
+        benchAddUndirected(graph, u, v, benchRandomRange(&state, 1, maxWeight));
+    }
+    return graph;
+}
+
+/*
+ * Returns an R-MAT graph with 2^scale vertices and edgeFactor * 2^scale
+ * directed edges, weights in 1..maxWeight. Each edge picks one quadrant
+ * of the adjacency matrix per bit with the usual Graph500 probabilities
+ * 0.57, 0.19, 0.19 and 0.05, which gives a skewed, power-law-like degree
+ * distribution. Self-loops are dropped.
+ */
+static inline Graph* benchRMATGraph(int scale, int edgeFactor, int maxWeight, uint64_t seed) {
+    int numVertices = 1 << scale;
+    Graph* graph = newGraph(numVertices);
+    if (graph == NULL) {
+        return NULL;
+    }
+    uint64_t state = seed | 1;
+    long numDirected = (long)numVertices * edgeFactor;
+    for (long i = 0; i < numDirected; i++) {
+        int u = 0;
+        int v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            int r = benchRandomRange(&state, 0, 99);
+            u = 2 * u + (r >= 76);  // quadrants c and d: 0.19 + 0.05
+            v = 2 * v + ((r >= 57 && r < 76) || r >= 95);  // quadrants b and d
+        }
+        if (u != v) {
+            graph->vertices[u]->adjList = newEdgeList(
+                newEdge(u, v, benchRandomRange(&state, 1, maxWeight)),
+                graph->vertices[u]->adjList);
+            graph->numEdges++;
+        }
+    }
+    return graph;
+}
+
+/*
+ * Returns the undirected path 0 -- 1 -- ... -- numVertices-1, weights in
+ * 1..maxWeight: the worst case for path lengths and search depth.
+ */
+static inline Graph* benchChainGraph(int numVertices, int maxWeight, uint64_t seed) {
+    Graph* graph = newGraph(numVertices);
+    if (graph == NULL) {
+        return NULL;
+    }
+    uint64_t state = seed | 1;
+    for (int v = 1; v < numVertices; v++) {
+        benchAddUndirected(graph, v - 1, v, benchRandomRange(&state, 1, maxWeight));
+    }
+    return graph;
+}
+
+/*
+ * Returns the total weight of 'path', or -1 if it is NULL.
+ */
+static inline long benchPathWeight(EdgeList* path) {
+    if (path == NULL) {
+        return -1;
+    }
+    long total = 0;
+    for (; path != NULL; path = path->next) {
+        total += path->edge->weight;
+    }
+    return total;
+}
+
+#endif
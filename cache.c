@@ -0,0 +1,208 @@
+/*
+ * LRU cache of distance trees.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
+#include "graph_algos.h"
+
+/*
+ * A cached tree, on a doubly linked list from most to least recently
+ * used.
+ */
+typedef struct cacheEntry
+{
+  int source;
+  unsigned long version;     // graph->version the tree was computed on
+  Edge* distTree;
+  struct cacheEntry* prev;   // more recently used
+  struct cacheEntry* next;   // less recently used
+} CacheEntry;
+
+struct distanceCache
+{
+  Graph* graph;
+  size_t maxBytes;
+  size_t entryBytes;         // what one entry costs, tree included
+  unsigned long version;     // graph->version of every entry
+  CacheEntry** bySource;     // bySource[s] is the entry of s or NULL
+  CacheEntry* newest;
+  CacheEntry* oldest;
+  DistanceCacheStats stats;
+};
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+static void unlinkEntry(DistanceCache* cache, CacheEntry* entry) {
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        cache->newest = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    } else {
+        cache->oldest = entry->prev;
+    }
+}
+
+static void pushNewest(DistanceCache* cache, CacheEntry* entry) {
+    entry->prev = NULL;
+    entry->next = cache->newest;
+    if (cache->newest != NULL) {
+        cache->newest->prev = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+static void dropEntry(DistanceCache* cache, CacheEntry* entry) {
+    unlinkEntry(cache, entry);
+    cache->bySource[entry->source] = NULL;
+    cache->stats.numEntries--;
+    cache->stats.bytes -= cache->entryBytes;
+    free(entry->distTree);
+    free(entry);
+}
+
+/*
+ * Drops every entry if the graph has changed since they were computed.
+ */
+static void checkVersion(DistanceCache* cache) {
+    if (cache->graph->version != cache->version) {
+        cache->stats.invalidations += cache->stats.numEntries;
+        while (cache->newest != NULL) {
+            dropEntry(cache, cache->newest);
+        }
+        cache->version = cache->graph->version;
+    }
+}
+
+/*
+ * Returns the cached tree of 'source', computing it on a miss, or NULL
+ * if it could not be computed. A tree too large to be cached is stored
+ * in '*uncached' for the caller to free.
+ */
+static Edge* lookupTree(DistanceCache* cache, int source, Edge** uncached) {
+    *uncached = NULL;
+    checkVersion(cache);
+    CacheEntry* entry = cache->bySource[source];
+    if (entry != NULL && entry->version == cache->graph->version) {
+        cache->stats.hits++;
+        unlinkEntry(cache, entry);
+        pushNewest(cache, entry);
+        return entry->distTree;
+    }
+    cache->stats.misses++;
+    Edge* distTree = getDistanceTreeDijkstra(cache->graph, source);
+    if (distTree == NULL) {
+        return NULL;
+    }
+    entry = cache->entryBytes <= cache->maxBytes ? (CacheEntry*)malloc(sizeof(CacheEntry)) : NULL;
+    if (entry == NULL) {
+        *uncached = distTree;
+        return distTree;
+    }
+    while (cache->stats.bytes + cache->entryBytes > cache->maxBytes) {
+        dropEntry(cache, cache->oldest);
+        cache->stats.evictions++;
+    }
+    entry->source = source;
+    entry->version = cache->version;
+    entry->distTree = distTree;
+    pushNewest(cache, entry);
+    cache->bySource[source] = entry;
+    cache->stats.numEntries++;
+    cache->stats.bytes += cache->entryBytes;
+    return distTree;
+}
+
+/*************************************************************************
+ ** Public interface
+ *************************************************************************/
+
+DistanceCache* newDistanceCache(Graph* graph, size_t maxBytes) {
+    if (graph == NULL || graph->numVertices <= 0) {
+        return NULL;
+    }
+    DistanceCache* cache = (DistanceCache*)calloc(1, sizeof(DistanceCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->bySource = (CacheEntry**)calloc(graph->numVertices, sizeof(CacheEntry*));
+    if (cache->bySource == NULL) {
+        free(cache);
+        return NULL;
+    }
+    cache->graph = graph;
+    cache->maxBytes = maxBytes;
+    cache->entryBytes = sizeof(CacheEntry) + graph->numVertices * sizeof(Edge);
+    cache->version = graph->version;
+    cache->stats.maxBytes = maxBytes;
+    return cache;
+}
+
+void deleteDistanceCache(DistanceCache* cache) {
+    if (cache != NULL) {
+        clearDistanceCache(cache);
+        free(cache->bySource);
+        free(cache);
+    }
+}
+
+void clearDistanceCache(DistanceCache* cache) {
+    if (cache != NULL) {
+        while (cache->newest != NULL) {
+            dropEntry(cache, cache->newest);
+        }
+    }
+}
+
+Edge* getCachedDistanceTree(DistanceCache* cache, int source) {
+    if (cache == NULL || source < 0 || source >= cache->graph->numVertices) {
+        return NULL;
+    }
+    Edge* uncached;
+    Edge* distTree = lookupTree(cache, source, &uncached);
+    if (distTree == NULL || uncached != NULL) {
+        return distTree;  // already the caller's
+    }
+    size_t size = cache->graph->numVertices * sizeof(Edge);
+    Edge* copy = (Edge*)malloc(size);
+    if (copy != NULL) {
+        memcpy(copy, distTree, size);
+    }
+    return copy;
+}
+
+EdgeList* getCachedShortestPath(DistanceCache* cache, int source, int target) {
+    if (cache == NULL || source < 0 || source >= cache->graph->numVertices ||
+        target < 0 || target >= cache->graph->numVertices || source == target) {
+        return NULL;
+    }
+    Edge* uncached;
+    Edge* distTree = lookupTree(cache, source, &uncached);
+    if (distTree == NULL) {
+        return NULL;
+    }
+    EdgeList* path = NULL;
+    // unreached entries are all zeros; a reached one names its vertex
+    // and a predecessor other than it
+    if (distTree[target].toVertex == target && distTree[target].fromVertex != target) {
+        path = makePath(distTree, target, source);
+    }
+    free(uncached);
+    return path;
+}
+
+DistanceCacheStats getDistanceCacheStats(DistanceCache* cache) {
+    if (cache == NULL) {
+        DistanceCacheStats none = {0};
+        return none;
+    }
+    return cache->stats;
+}
@@ -0,0 +1,63 @@
+/*
+ * LRU cache of distance trees for skewed query mixes.
+ *
+ * A DistanceCache belongs to one graph and keeps the distance trees of
+ * the sources queried most recently, keyed by (graph->version, source),
+ * within a budget of bytes. When the graph's version moves on, every
+ * entry is dropped on the next call, so a tree computed before an edge
+ * update is never served after it. A cache is not thread-safe: use one
+ * per thread or lock around it.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include "graph.h"
+
+typedef struct distanceCache DistanceCache;
+
+typedef struct distanceCacheStats
+{
+  long hits;
+  long misses;
+  long evictions;      // entries dropped to stay within the budget
+  long invalidations;  // entries dropped because the graph changed
+  int numEntries;
+  size_t bytes;        // held by the entries, within maxBytes
+  size_t maxBytes;
+} DistanceCacheStats;
+
+/*
+ * Creates and returns an empty cache for 'graph' that holds at most
+ * 'maxBytes' of entries. Returns NULL on invalid arguments or
+ * allocation failure.
+ */
+DistanceCache* newDistanceCache(Graph* graph, size_t maxBytes);
+void deleteDistanceCache(DistanceCache* cache);
+
+/*
+ * Drops every entry; the counters are kept.
+ */
+void clearDistanceCache(DistanceCache* cache);
+
+/*
+ * Same as getDistanceTreeDijkstra on the cache's graph: returns a new
+ * copy of the tree, which the caller frees, computing and caching it
+ * first on a miss. A tree larger than the whole budget is returned
+ * without being cached. Returns NULL on invalid arguments or allocation
+ * failure.
+ */
+Edge* getCachedDistanceTree(DistanceCache* cache, int source);
+
+/*
+ * Same as getShortestPath on the cache's graph, but built from the
+ * cached tree of 'source' in time proportional to the path's length.
+ * Returns NULL if 'target' is unreachable, equals 'source', or on
+ * invalid arguments or allocation failure.
+ */
+EdgeList* getCachedShortestPath(DistanceCache* cache, int source, int target);
+
+DistanceCacheStats getDistanceCacheStats(DistanceCache* cache);
+
+#endif
@@ -0,0 +1,848 @@
+/*
+ * Contraction hierarchies: preprocessing and queries.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include "ch.h"
+#include "graph_algos.h"
+#include "pq.h"
+#include "search_queue.h"
+
+// a witness search gives up after settling this many vertices, and does
+// not follow paths of more than this many arcs; a witness it misses only
+// costs an unnecessary shortcut. Simulated contractions, which only
+// estimate a priority, search less than real ones.
+#define WITNESS_SETTLE_LIMIT 500
+#define WITNESS_HOP_LIMIT 8
+#define SIMULATED_SETTLE_LIMIT 100
+#define SIMULATED_HOP_LIMIT 3
+
+// distances and arc weights are int64_t, so that paths and shortcuts of
+// INT_MAX or more stay exact; the searches queue them in a lazy heap
+DEFINE_SEARCH_QUEUE_LAZY(CHQueue, int64_t)
+
+/*
+ * An arc of the graph being contracted. In an out list 'target' is the
+ * head of the arc, in an in list it is the tail.
+ */
+typedef struct chArc
+{
+  int target;
+  int64_t weight;
+  int middle;  // contracted vertex this shortcut skips, -1 if original
+} CHArc;
+
+typedef struct arcList
+{
+  int size;
+  int capacity;
+  CHArc* arcs;
+} ArcList;
+
+/*
+ * State of a running contraction. The arc lists of an uncontracted
+ * vertex only hold arcs to and from uncontracted vertices: contracting v
+ * removes its arcs from its neighbours' lists, and leaves in v's own
+ * lists exactly its arcs to and from higher ranked vertices.
+ */
+typedef struct contraction
+{
+  int numVertices;
+  ArcList* out;            // out[u] holds the arcs u -> target
+  ArcList* in;             // in[v] holds the arcs target -> v
+  bool* contracted;        // contracted[id] is true iff id is contracted
+  int* deletedNeighbors;   // contracted neighbours, part of the priority
+  int64_t* distances;      // witness search distances, INT64_MAX if untouched
+  int* hops;               // witness search arcs from the source
+  bool* isTarget;          // out-neighbours of the vertex being contracted
+  int* touched;            // vertices whose distance the last search set
+  int numTouched;
+  CHQueue heap;            // witness search queue
+  int numShortcuts;
+} Contraction;
+
+/*
+ * One step of a path over the search graph, from 'from' to 'to'.
+ */
+typedef struct chStep
+{
+  int from;
+  int to;
+  int64_t weight;
+  int middle;
+} CHStep;
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+static bool arcListPush(ArcList* list, CHArc arc) {
+    if (list->size == list->capacity) {
+        int newCapacity = list->capacity == 0 ? 4 : 2 * list->capacity;
+        CHArc* arcs = (CHArc*)realloc(list->arcs, newCapacity * sizeof(CHArc));
+        if (arcs == NULL) {
+            return false;
+        }
+        list->arcs = arcs;
+        list->capacity = newCapacity;
+    }
+    list->arcs[list->size++] = arc;
+    return true;
+}
+
+static int findArc(ArcList* list, int target) {
+    for (int i = 0; i < list->size; i++) {
+        if (list->arcs[i].target == target) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Removes the arc with 'target' from 'list', which must hold one.
+ */
+static void removeArc(ArcList* list, int target) {
+    int i = findArc(list, target);
+    list->arcs[i] = list->arcs[--list->size];
+}
+
+/*
+ * Adds arc u -> x of weight 'weight' skipping 'middle', or lowers the
+ * weight of the existing u -> x arc if the new one is shorter. Parallel
+ * arcs are never created. Returns false on allocation failure.
+ */
+static bool addArc(Contraction* c, int u, int x, int64_t weight, int middle) {
+    int outIndex = findArc(&c->out[u], x);
+    if (outIndex != -1) {
+        if (weight < c->out[u].arcs[outIndex].weight) {
+            int inIndex = findArc(&c->in[x], u);
+            c->out[u].arcs[outIndex].weight = weight;
+            c->out[u].arcs[outIndex].middle = middle;
+            c->in[x].arcs[inIndex].weight = weight;
+            c->in[x].arcs[inIndex].middle = middle;
+        }
+        return true;
+    }
+    CHArc outArc = {x, weight, middle};
+    CHArc inArc = {u, weight, middle};
+    return arcListPush(&c->out[u], outArc) && arcListPush(&c->in[x], inArc);
+}
+
+static void freeContraction(Contraction* c) {
+    if (c->out != NULL) {
+        for (int v = 0; v < c->numVertices; v++) {
+            free(c->out[v].arcs);
+        }
+    }
+    if (c->in != NULL) {
+        for (int v = 0; v < c->numVertices; v++) {
+            free(c->in[v].arcs);
+        }
+    }
+    free(c->out);
+    free(c->in);
+    free(c->contracted);
+    free(c->deletedNeighbors);
+    free(c->distances);
+    free(c->hops);
+    free(c->isTarget);
+    free(c->touched);
+    CHQueueFree(&c->heap);
+}
+
+/*
+ * Runs a Dijkstra from 'source' over uncontracted vertices other than
+ * 'excluded', until the 'numTargets' vertices marked in c->isTarget are
+ * settled, up to distance 'maxDistance', 'settleLimit' settled vertices
+ * and paths of 'hopLimit' arcs. Leaves the results in c->distances.
+ * Returns false on allocation failure.
+ */
+static bool witnessSearch(Contraction* c, int source, int excluded, int numTargets,
+                          int64_t maxDistance, int settleLimit, int hopLimit) {
+    for (int i = 0; i < c->numTouched; i++) {
+        c->distances[c->touched[i]] = INT64_MAX;
+    }
+    c->numTouched = 0;
+    CHQueueClear(&c->heap);
+    c->distances[source] = 0;
+    c->hops[source] = 0;
+    c->touched[c->numTouched++] = source;
+    if (!CHQueuePush(&c->heap, 0, source)) {
+        return false;
+    }
+    int settled = 0;
+    while (!CHQueueIsEmpty(&c->heap)) {
+        int64_t key;
+        int u = CHQueuePop(&c->heap, &key);
+        if (key > c->distances[u]) {
+            continue;  // stale entry
+        }
+        if (key > maxDistance || ++settled > settleLimit ||
+            (c->isTarget[u] && --numTargets == 0)) {
+            break;
+        }
+        if (c->hops[u] == hopLimit) {
+            continue;
+        }
+        ArcList* out = &c->out[u];
+        for (int i = 0; i < out->size; i++) {
+            int x = out->arcs[i].target;
+            if (x == excluded) {
+                continue;
+            }
+            int64_t distance = c->distances[u] + out->arcs[i].weight;
+            if (distance < c->distances[x]) {
+                if (c->distances[x] == INT64_MAX) {
+                    c->touched[c->numTouched++] = x;
+                }
+                c->distances[x] = distance;
+                c->hops[x] = c->hops[u] + 1;
+                if (!CHQueuePush(&c->heap, distance, x)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Finds the shortcuts needed to contract 'v' and adds them unless
+ * 'simulate' is set. Returns the number of shortcuts, or -1 on
+ * allocation failure.
+ */
+static int contractVertex(Contraction* c, int v, bool simulate) {
+    ArcList* out = &c->out[v];
+    for (int j = 0; j < out->size; j++) {
+        c->isTarget[out->arcs[j].target] = true;
+    }
+    int numShortcuts = 0;
+    for (int i = 0; i < c->in[v].size && numShortcuts != -1; i++) {
+        int u = c->in[v].arcs[i].target;
+        int64_t toV = c->in[v].arcs[i].weight;
+        int64_t maxDistance = -1;
+        for (int j = 0; j < out->size; j++) {
+            int x = out->arcs[j].target;
+            if (x != u && toV + out->arcs[j].weight > maxDistance) {
+                maxDistance = toV + out->arcs[j].weight;
+            }
+        }
+        if (maxDistance == -1) {
+            continue;  // no u -> v -> x path to preserve
+        }
+        bool searched = simulate
+            ? witnessSearch(c, u, v, out->size, maxDistance, SIMULATED_SETTLE_LIMIT,
+                            SIMULATED_HOP_LIMIT)
+            : witnessSearch(c, u, v, out->size, maxDistance, WITNESS_SETTLE_LIMIT,
+                            WITNESS_HOP_LIMIT);
+        for (int j = 0; searched && j < out->size; j++) {
+            int x = out->arcs[j].target;
+            int64_t viaV = toV + out->arcs[j].weight;
+            if (x == u || c->distances[x] <= viaV) {
+                continue;
+            }
+            numShortcuts++;
+            if (!simulate) {
+                searched = addArc(c, u, x, viaV, v);
+                c->numShortcuts++;
+            }
+        }
+        if (!searched) {
+            numShortcuts = -1;
+        }
+    }
+    for (int j = 0; j < out->size; j++) {
+        c->isTarget[out->arcs[j].target] = false;
+    }
+    return numShortcuts;
+}
+
+/*
+ * Returns the contraction priority of 'v': shortcuts added minus arcs
+ * removed, plus the number of already contracted neighbours so that
+ * contraction spreads evenly over the graph. Lower is contracted first.
+ * Returns INT_MIN on allocation failure.
+ */
+static int contractionPriority(Contraction* c, int v) {
+    int removed = c->in[v].size + c->out[v].size;
+    int numShortcuts = contractVertex(c, v, true);
+    if (numShortcuts < 0) {
+        return INT_MIN;
+    }
+    return numShortcuts - removed + c->deletedNeighbors[v];
+}
+
+/*
+ * Builds one half of the search graph: for every vertex v, the arcs of
+ * lists[v] whose other end ranks above v, as CSR arrays.
+ */
+static bool buildSearchHalf(Contraction* c, ArcList* lists, int* rank, int** offsets,
+                            int** targets, int64_t** weights, int** middles) {
+    int n = c->numVertices;
+    *offsets = (int*)calloc(n + 1, sizeof(int));
+    if (*offsets == NULL) {
+        return false;
+    }
+    for (int v = 0; v < n; v++) {
+        int count = 0;
+        for (int i = 0; i < lists[v].size; i++) {
+            count += rank[lists[v].arcs[i].target] > rank[v];
+        }
+        (*offsets)[v + 1] = (*offsets)[v] + count;
+    }
+    int numArcs = (*offsets)[n];
+    *targets = (int*)malloc((numArcs + 1) * sizeof(int));
+    *weights = (int64_t*)malloc((numArcs + 1) * sizeof(int64_t));
+    *middles = (int*)malloc((numArcs + 1) * sizeof(int));
+    if (*targets == NULL || *weights == NULL || *middles == NULL) {
+        return false;
+    }
+    int pos = 0;
+    for (int v = 0; v < n; v++) {
+        for (int i = 0; i < lists[v].size; i++) {
+            CHArc* arc = &lists[v].arcs[i];
+            if (rank[arc->target] > rank[v]) {
+                (*targets)[pos] = arc->target;
+                (*weights)[pos] = arc->weight;
+                (*middles)[pos] = arc->middle;
+                pos++;
+            }
+        }
+    }
+    return true;
+}
+
+/*************************************************************************
+ ** Preprocessing
+ *************************************************************************/
+
+CHGraph* newCHGraph(Graph* graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    Contraction c = {0};
+    c.numVertices = n;
+    c.out = (ArcList*)calloc(n, sizeof(ArcList));
+    c.in = (ArcList*)calloc(n, sizeof(ArcList));
+    c.contracted = (bool*)calloc(n, sizeof(bool));
+    c.deletedNeighbors = (int*)calloc(n, sizeof(int));
+    c.distances = (int64_t*)malloc(n * sizeof(int64_t));
+    c.hops = (int*)malloc(n * sizeof(int));
+    c.isTarget = (bool*)calloc(n, sizeof(bool));
+    c.touched = (int*)malloc(n * sizeof(int));
+    bool queued = CHQueueInit(&c.heap, n);
+    CHGraph* ch = (CHGraph*)calloc(1, sizeof(CHGraph));
+    PriorityQueue* order = newPQ(PQ_LAZY_HEAP, n);
+    if (c.out == NULL || c.in == NULL || c.contracted == NULL || c.deletedNeighbors == NULL ||
+        c.distances == NULL || c.hops == NULL || c.isTarget == NULL || c.touched == NULL ||
+        !queued || ch == NULL || order == NULL) {
+        freeContraction(&c);
+        deletePQ(order);
+        free(ch);
+        return NULL;
+    }
+    ch->numVertices = n;
+    ch->rank = (int*)malloc(n * sizeof(int));
+    if (ch->rank == NULL) {
+        freeContraction(&c);
+        deletePQ(order);
+        deleteCHGraph(ch);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        c.distances[v] = INT64_MAX;
+    }
+    bool ok = true;
+    for (int u = 0; u < n && ok; u++) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            Edge* edge = adjList->edge;
+            if (edge->toVertex != u && !addArc(&c, u, edge->toVertex, edge->weight, -1)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    for (int v = 0; v < n && ok; v++) {
+        int priority = contractionPriority(&c, v);
+        ok = priority != INT_MIN && pqPush(order, priority, v);
+    }
+    int nextRank = 0;
+    while (ok && !pqIsEmpty(order)) {
+        int v = pqExtractMin(order).id;
+        if (c.contracted[v]) {
+            continue;
+        }
+        // lazy update: priorities only grow stale, so recheck before use
+        int priority = contractionPriority(&c, v);
+        if (priority == INT_MIN) {
+            ok = false;
+            break;
+        }
+        if (!pqIsEmpty(order) && priority > pqGetMin(order).priority) {
+            ok = pqPush(order, priority, v);
+            continue;
+        }
+        if (contractVertex(&c, v, false) < 0) {
+            ok = false;
+            break;
+        }
+        c.contracted[v] = true;
+        ch->rank[v] = nextRank++;
+        // v keeps its arcs as its search graph arcs; its neighbours drop
+        // theirs so that no later search or priority scans them again
+        for (int i = 0; i < c.in[v].size; i++) {
+            int u = c.in[v].arcs[i].target;
+            c.deletedNeighbors[u]++;
+            removeArc(&c.out[u], v);
+        }
+        for (int i = 0; i < c.out[v].size; i++) {
+            int x = c.out[v].arcs[i].target;
+            c.deletedNeighbors[x]++;
+            removeArc(&c.in[x], v);
+        }
+    }
+    ch->numShortcuts = c.numShortcuts;
+    ok = ok &&
+         buildSearchHalf(&c, c.out, ch->rank, &ch->upOffsets, &ch->upTargets,
+                         &ch->upWeights, &ch->upMiddles) &&
+         buildSearchHalf(&c, c.in, ch->rank, &ch->downOffsets, &ch->downTargets,
+                         &ch->downWeights, &ch->downMiddles);
+    freeContraction(&c);
+    deletePQ(order);
+    if (!ok) {
+        deleteCHGraph(ch);
+        return NULL;
+    }
+    return ch;
+}
+
+void deleteCHGraph(CHGraph* ch) {
+    if (ch != NULL) {
+        free(ch->rank);
+        free(ch->upOffsets);
+        free(ch->upTargets);
+        free(ch->upWeights);
+        free(ch->upMiddles);
+        free(ch->downOffsets);
+        free(ch->downTargets);
+        free(ch->downWeights);
+        free(ch->downMiddles);
+        free(ch);
+    }
+}
+
+/*************************************************************************
+ ** Queries
+ *************************************************************************/
+
+/*
+ * One direction of a CH query. Entries other than reached are only
+ * meaningful where reached is set.
+ */
+typedef struct chSide
+{
+  int* offsets;         // search graph half this side scans
+  int* targets;
+  int64_t* weights;
+  bool* reached;
+  int64_t* distances;
+  int* predecessors;    // previous vertex towards the side's source
+  int* predArcs;        // index of the arc used to reach the vertex
+  CHQueue heap;
+} CHSide;
+
+static void freeCHSide(CHSide* side) {
+    free(side->reached);
+    free(side->distances);
+    free(side->predecessors);
+    free(side->predArcs);
+    CHQueueFree(&side->heap);
+}
+
+static bool initCHSide(CHSide* side, int* offsets, int* targets, int64_t* weights,
+                       int n, int source) {
+    side->offsets = offsets;
+    side->targets = targets;
+    side->weights = weights;
+    side->reached = (bool*)calloc(n, sizeof(bool));
+    side->distances = (int64_t*)malloc(n * sizeof(int64_t));
+    side->predecessors = (int*)malloc(n * sizeof(int));
+    side->predArcs = (int*)malloc(n * sizeof(int));
+    bool queued = CHQueueInit(&side->heap, n);
+    if (side->reached == NULL || side->distances == NULL || side->predecessors == NULL ||
+        side->predArcs == NULL || !queued) {
+        freeCHSide(side);
+        return false;
+    }
+    side->reached[source] = true;
+    side->distances[source] = 0;
+    side->predecessors[source] = -1;
+    CHQueuePush(&side->heap, 0, source);
+    return true;
+}
+
+/*
+ * Settles the next vertex of 'side', relaxes its arcs and lowers 'best'
+ * if 'other' has reached it. Returns false on allocation failure.
+ */
+static bool chStep(CHSide* side, CHSide* other, int64_t* best, int* meeting) {
+    int64_t key;
+    int u = CHQueuePop(&side->heap, &key);
+    if (key > side->distances[u]) {
+        return true;  // stale entry
+    }
+    if (other->reached[u] && side->distances[u] + other->distances[u] < *best) {
+        *best = side->distances[u] + other->distances[u];
+        *meeting = u;
+    }
+    for (int i = side->offsets[u]; i < side->offsets[u + 1]; i++) {
+        int x = side->targets[i];
+        int64_t distance = side->distances[u] + side->weights[i];
+        if (!side->reached[x] || distance < side->distances[x]) {
+            side->reached[x] = true;
+            side->distances[x] = distance;
+            side->predecessors[x] = u;
+            side->predArcs[x] = i;
+            if (!CHQueuePush(&side->heap, distance, x)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool stepsPush(CHStep** steps, int* size, int* capacity, CHStep step) {
+    if (*size == *capacity) {
+        int newCapacity = *capacity == 0 ? 16 : 2 * *capacity;
+        CHStep* grown = (CHStep*)realloc(*steps, newCapacity * sizeof(CHStep));
+        if (grown == NULL) {
+            return false;
+        }
+        *steps = grown;
+        *capacity = newCapacity;
+    }
+    (*steps)[(*size)++] = step;
+    return true;
+}
+
+/*
+ * Returns the index of the arc middle -> head in the upward half, or of
+ * tail -> middle in the downward half. Such an arc always exists for the
+ * two halves of a shortcut skipping 'middle'.
+ */
+static int findSearchArc(int* offsets, int* targets, int middle, int other) {
+    for (int i = offsets[middle]; i < offsets[middle + 1]; i++) {
+        if (targets[i] == other) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Unpacks 'steps' (in order, s to t, as a stack with the first step on
+ * top) into original edges and returns them in getShortestPaths format.
+ * Frees 'steps'.
+ */
+static EdgeList* unpackPath(CHGraph* ch, CHStep* steps, int size, int capacity) {
+    EdgeList* path = NULL;
+    // paths are calloc'd, whatever the caller's current arena is
+    Arena* previous = setCurrentArena(NULL);
+    while (size > 0) {
+        CHStep step = steps[--size];
+        if (step.middle == -1) {
+            // prepend, so the last edge (into t) ends up first
+            Edge* edge = newEdge(step.to, step.from, (int)step.weight);
+            EdgeList* node = (edge == NULL) ? NULL : newEdgeList(edge, path);
+            if (node == NULL) {
+                arenaFree(edge);
+                deleteEdgeList(path);
+                free(steps);
+                setCurrentArena(previous);
+                return NULL;
+            }
+            path = node;
+            continue;
+        }
+        int m = step.middle;
+        int down = findSearchArc(ch->downOffsets, ch->downTargets, m, step.from);
+        int up = findSearchArc(ch->upOffsets, ch->upTargets, m, step.to);
+        CHStep second = {m, step.to, ch->upWeights[up], ch->upMiddles[up]};
+        CHStep first = {step.from, m, ch->downWeights[down], ch->downMiddles[down]};
+        if (!stepsPush(&steps, &size, &capacity, second) ||
+            !stepsPush(&steps, &size, &capacity, first)) {
+            deleteEdgeList(path);
+            free(steps);
+            setCurrentArena(previous);
+            return NULL;
+        }
+    }
+    free(steps);
+    setCurrentArena(previous);
+    return path;
+}
+
+EdgeList* getShortestPathCH(CHGraph* ch, int startVertex, int targetVertex) {
+    if (ch == NULL || startVertex < 0 || startVertex >= ch->numVertices ||
+        targetVertex < 0 || targetVertex >= ch->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    int n = ch->numVertices;
+    CHSide forward, backward;
+    if (!initCHSide(&forward, ch->upOffsets, ch->upTargets, ch->upWeights, n, startVertex)) {
+        return NULL;
+    }
+    if (!initCHSide(&backward, ch->downOffsets, ch->downTargets, ch->downWeights, n,
+                    targetVertex)) {
+        freeCHSide(&forward);
+        return NULL;
+    }
+    int64_t best = INT64_MAX;
+    int meeting = -1;
+    bool ok = true;
+    // each side stops once its smallest key cannot improve 'best'
+    while (ok) {
+        bool forwardLive = !CHQueueIsEmpty(&forward.heap) && forward.heap.entries[0].key < best;
+        bool backwardLive = !CHQueueIsEmpty(&backward.heap) && backward.heap.entries[0].key < best;
+        if (!forwardLive && !backwardLive) {
+            break;
+        }
+        if (forwardLive) {
+            ok = chStep(&forward, &backward, &best, &meeting);
+        }
+        if (ok && backwardLive) {
+            ok = chStep(&backward, &forward, &best, &meeting);
+        }
+    }
+    EdgeList* path = NULL;
+    if (ok && meeting != -1) {
+        // collect the search graph path as a stack with the step leaving
+        // startVertex on top: push meeting -> t backwards, then s -> meeting
+        CHStep* steps = NULL;
+        int size = 0;
+        int capacity = 0;
+        int numBackward = 0;
+        for (int v = meeting; ok && v != targetVertex; v = backward.predecessors[v]) {
+            numBackward++;
+            int arc = backward.predArcs[v];
+            CHStep step = {v, backward.predecessors[v], ch->downWeights[arc], ch->downMiddles[arc]};
+            ok = stepsPush(&steps, &size, &capacity, step);
+        }
+        // reverse the backward part so that the step into t is at the bottom
+        for (int i = 0; ok && i < numBackward / 2; i++) {
+            CHStep temp = steps[i];
+            steps[i] = steps[numBackward - 1 - i];
+            steps[numBackward - 1 - i] = temp;
+        }
+        for (int v = meeting; ok && v != startVertex; v = forward.predecessors[v]) {
+            int arc = forward.predArcs[v];
+            CHStep step = {forward.predecessors[v], v, ch->upWeights[arc], ch->upMiddles[arc]};
+            ok = stepsPush(&steps, &size, &capacity, step);
+        }
+        if (ok) {
+            path = unpackPath(ch, steps, size, capacity);
+        } else {
+            free(steps);
+        }
+    }
+    freeCHSide(&forward);
+    freeCHSide(&backward);
+    return path;
+}
+
+/*************************************************************************
+ ** Many-to-many distance tables
+ *************************************************************************/
+
+/*
+ * A search over one half of the search graph that can be run again and
+ * again; only the vertices it reached are put back between runs.
+ */
+typedef struct upwardSearch
+{
+  int64_t* distances;   // INT64_MAX where not reached
+  int* reached;         // vertices reached by the last run
+  int numReached;
+  CHQueue heap;
+} UpwardSearch;
+
+/*
+ * An entry of the bucket of a vertex v: the distance from v to targets[target].
+ */
+typedef struct bucketEntry
+{
+  int vertex;    // only used while the buckets are being collected
+  int target;
+  int64_t distance;
+} BucketEntry;
+
+static void freeUpwardSearch(UpwardSearch* search) {
+    free(search->distances);
+    free(search->reached);
+    CHQueueFree(&search->heap);
+}
+
+static bool initUpwardSearch(UpwardSearch* search, int n) {
+    search->distances = (int64_t*)malloc(n * sizeof(int64_t));
+    search->reached = (int*)malloc(n * sizeof(int));
+    search->numReached = 0;
+    bool queued = CHQueueInit(&search->heap, n);
+    if (search->distances == NULL || search->reached == NULL || !queued) {
+        freeUpwardSearch(search);
+        return false;
+    }
+    for (int v = 0; v < n; v++) {
+        search->distances[v] = INT64_MAX;
+    }
+    return true;
+}
+
+/*
+ * Undoes the last run, then searches exhaustively from 'source' over the
+ * arcs in 'offsets', 'targets' and 'weights'. Afterwards every vertex in
+ * search->reached holds its final distance in the search graph half.
+ * Returns false on allocation failure.
+ */
+static bool runUpwardSearch(UpwardSearch* search, int* offsets, int* targets,
+                            int64_t* weights, int source) {
+    for (int i = 0; i < search->numReached; i++) {
+        search->distances[search->reached[i]] = INT64_MAX;
+    }
+    search->numReached = 0;
+    search->distances[source] = 0;
+    search->reached[search->numReached++] = source;
+    CHQueueClear(&search->heap);
+    if (!CHQueuePush(&search->heap, 0, source)) {
+        return false;
+    }
+    while (!CHQueueIsEmpty(&search->heap)) {
+        int64_t key;
+        int u = CHQueuePop(&search->heap, &key);
+        if (key > search->distances[u]) {
+            continue;  // stale entry
+        }
+        for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+            int x = targets[i];
+            int64_t distance = search->distances[u] + weights[i];
+            if (distance < search->distances[x]) {
+                if (search->distances[x] == INT64_MAX) {
+                    search->reached[search->numReached++] = x;
+                }
+                search->distances[x] = distance;
+                if (!CHQueuePush(&search->heap, distance, x)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool getDistanceTableCH(CHGraph* ch, int* sources, int numSources, int* targets,
+                        int numTargets, int64_t* table) {
+    if (ch == NULL || sources == NULL || targets == NULL || table == NULL ||
+        numSources < 0 || numTargets < 0) {
+        return false;
+    }
+    int n = ch->numVertices;
+    UpwardSearch search;
+    if (!initUpwardSearch(&search, n)) {
+        return false;
+    }
+    // backward searches from every target leave (target, distance) in the
+    // bucket of every vertex they reach
+    BucketEntry* entries = NULL;
+    long numEntries = 0;
+    long capacity = 0;
+    for (int j = 0; j < numTargets; j++) {
+        if (targets[j] < 0 || targets[j] >= n) {
+            continue;
+        }
+        if (!runUpwardSearch(&search, ch->downOffsets, ch->downTargets, ch->downWeights,
+                             targets[j])) {
+            free(entries);
+            freeUpwardSearch(&search);
+            return false;
+        }
+        if (numEntries + search.numReached > capacity) {
+            long newCapacity = capacity == 0 ? 1024 : 2 * capacity;
+            while (newCapacity < numEntries + search.numReached) {
+                newCapacity *= 2;
+            }
+            BucketEntry* grown = (BucketEntry*)realloc(entries, newCapacity * sizeof(BucketEntry));
+            if (grown == NULL) {
+                free(entries);
+                freeUpwardSearch(&search);
+                return false;
+            }
+            entries = grown;
+            capacity = newCapacity;
+        }
+        for (int i = 0; i < search.numReached; i++) {
+            int v = search.reached[i];
+            BucketEntry entry = {v, j, search.distances[v]};
+            entries[numEntries++] = entry;
+        }
+    }
+    // counting sort the entries into one bucket per vertex
+    long* bucketOffsets = (long*)calloc(n + 1, sizeof(long));
+    long* next = (long*)malloc(n * sizeof(long));
+    BucketEntry* buckets = (BucketEntry*)malloc((numEntries + 1) * sizeof(BucketEntry));
+    if (bucketOffsets == NULL || next == NULL || buckets == NULL) {
+        free(entries);
+        free(bucketOffsets);
+        free(next);
+        free(buckets);
+        freeUpwardSearch(&search);
+        return false;
+    }
+    for (long e = 0; e < numEntries; e++) {
+        bucketOffsets[entries[e].vertex + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        bucketOffsets[v + 1] += bucketOffsets[v];
+        next[v] = bucketOffsets[v];
+    }
+    for (long e = 0; e < numEntries; e++) {
+        buckets[next[entries[e].vertex]++] = entries[e];
+    }
+    free(next);
+    free(entries);
+
+    // a forward search from each source meets every target in the
+    // buckets of the vertices both searches reach
+    for (int i = 0; i < numSources; i++) {
+        int64_t* row = table + (size_t)i * numTargets;
+        for (int j = 0; j < numTargets; j++) {
+            row[j] = DISTANCE_TABLE_UNREACHABLE;
+        }
+        if (sources[i] < 0 || sources[i] >= n) {
+            continue;
+        }
+        if (!runUpwardSearch(&search, ch->upOffsets, ch->upTargets, ch->upWeights,
+                             sources[i])) {
+            free(bucketOffsets);
+            free(buckets);
+            freeUpwardSearch(&search);
+            return false;
+        }
+        for (int r = 0; r < search.numReached; r++) {
+            int u = search.reached[r];
+            int64_t distance = search.distances[u];
+            for (long e = bucketOffsets[u]; e < bucketOffsets[u + 1]; e++) {
+                int64_t total = distance + buckets[e].distance;
+                if (total < row[buckets[e].target]) {
+                    row[buckets[e].target] = total;
+                }
+            }
+        }
+    }
+    free(bucketOffsets);
+    free(buckets);
+    freeUpwardSearch(&search);
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * Contraction hierarchies.
+ *
+ * Preprocessing contracts the vertices of a Graph one at a time in order
+ * of importance, adding a shortcut u -> x of weight w(u, v) + w(v, x)
+ * whenever contracting v would otherwise lose the shortest u -> x path.
+ * Every edge, original or shortcut, then leads either up or down in the
+ * contraction order. A query runs a forward search from s over upward
+ * edges and a backward search from t over downward edges, and unpacks
+ * the shortcuts on the best meeting path.
+ */
+
+#ifndef CH_H
+#define CH_H
+
+#include <stdint.h>
+#include "graph.h"
+
+typedef struct chGraph
+{
+  int numVertices;
+  int numShortcuts;   // shortcut edges added by preprocessing
+  int* rank;          // rank[id] is the position of id in the order
+  // upward edges: v -> upTargets[i] for i in upOffsets[v]..upOffsets[v+1]-1
+  int* upOffsets;
+  int* upTargets;
+  int64_t* upWeights; // shortcut weights can exceed INT_MAX
+  int* upMiddles;     // contracted vertex a shortcut skips, -1 if original
+  // downward edges, stored at their lower end: downTargets[i] -> v
+  int* downOffsets;
+  int* downTargets;
+  int64_t* downWeights;
+  int* downMiddles;
+} CHGraph;
+
+/*
+ * Contracts every vertex of 'graph' and returns the resulting search
+ * graph. 'graph' is not modified and is not needed by queries.
+ * Edge weights must be non-negative.
+ * Returns NULL if 'graph' is NULL or on allocation failure.
+ */
+CHGraph* newCHGraph(Graph* graph);
+
+void deleteCHGraph(CHGraph* ch);
+
+/*
+ * Returns the shortest path from 'startVertex' to 'targetVertex' with all
+ * shortcuts unpacked into original edges, in the same format as the
+ * entries of getShortestPaths.
+ * Returns NULL if 'targetVertex' is unreachable, equals 'startVertex',
+ * or on invalid arguments or allocation failure.
+ */
+EdgeList* getShortestPathCH(CHGraph* ch, int startVertex, int targetVertex);
+
+/*
+ * Same as getDistanceTable (see graph_algos.h), but bucket-based: one
+ * backward upward search per target stores its distances in buckets at
+ * the vertices it reaches, and one forward upward search per source
+ * scans the buckets of the vertices it reaches. Every search is local to
+ * the top of the hierarchy, so the cost grows with the number of sources
+ * plus targets rather than their product.
+ */
+bool getDistanceTableCH(CHGraph* ch, int* sources, int numSources, int* targets,
+                        int numTargets, int64_t* table);
+
+#endif
@@ -0,0 +1,510 @@
+/*
+ * Resource-constrained shortest paths.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "constrained.h"
+
+#define LABELS_PER_CHUNK 1024
+#define UNREACHABLE LLONG_MAX
+
+/*
+ * A path from the start vertex to 'vertex': its weight, its totals of
+ * the CONSTRAINT_SUM attributes, and the label of the path it extends.
+ */
+typedef struct label
+{
+  long long weight;
+  int vertex;
+  bool settled;            // expanded, so other labels may extend it
+  bool dead;               // dominated while queued, freed when popped
+  Edge* edge;              // last edge of the path, NULL at the start
+  struct label* previous;  // label of the path without 'edge'
+  struct label* next;      // next label at 'vertex', or on the free list
+  int totals[];            // one per CONSTRAINT_SUM attribute
+} Label;
+
+/*
+ * Labels are carved out of chunks of LABELS_PER_CHUNK and go back on a
+ * free list when dropped, so a long search reuses its memory instead of
+ * growing with every label it ever made.
+ */
+typedef struct labelPool
+{
+  size_t labelSize;  // sizeof(Label) plus the totals, padded
+  char** chunks;
+  int numChunks;
+  int maxChunks;
+  int numUsed;       // labels handed out of the last chunk so far
+  Label* freeList;
+  long numLive;
+  long maxLive;      // 0 for no limit
+  long peakLive;
+} LabelPool;
+
+typedef struct queueEntry
+{
+  long long key;
+  int vertex;
+  Label* label;  // NULL in the searches for lower bounds
+} QueueEntry;
+
+typedef struct queue
+{
+  QueueEntry* entries;
+  int size;
+  int capacity;
+} Queue;
+
+/*
+ * The usable edges grouped by head: the edges into v are
+ * edges[offsets[v] .. offsets[v+1]-1].
+ */
+typedef struct reverseEdges
+{
+  int* offsets;
+  Edge** edges;
+} ReverseEdges;
+
+/*************************************************************************
+ ** Label pool
+ *************************************************************************/
+
+static void initLabelPool(LabelPool* pool, int numTotals, long maxLive) {
+    memset(pool, 0, sizeof(LabelPool));
+    size_t align = _Alignof(Label);
+    size_t size = sizeof(Label) + numTotals * sizeof(int);
+    pool->labelSize = (size + align - 1) / align * align;
+    pool->maxLive = maxLive;
+}
+
+static void freeLabelPool(LabelPool* pool) {
+    for (int i = 0; i < pool->numChunks; i++) {
+        free(pool->chunks[i]);
+    }
+    free(pool->chunks);
+}
+
+/*
+ * Returns a label from 'pool', or NULL if it holds maxLive labels or on
+ * allocation failure.
+ */
+static Label* allocLabel(LabelPool* pool) {
+    if (pool->maxLive > 0 && pool->numLive >= pool->maxLive) {
+        return NULL;
+    }
+    Label* label = pool->freeList;
+    if (label != NULL) {
+        pool->freeList = label->next;
+    } else {
+        if (pool->numChunks == 0 || pool->numUsed == LABELS_PER_CHUNK) {
+            if (pool->numChunks == pool->maxChunks) {
+                int maxChunks = pool->maxChunks > 0 ? 2 * pool->maxChunks : 16;
+                char** grown = (char**)realloc(pool->chunks, maxChunks * sizeof(char*));
+                if (grown == NULL) {
+                    return NULL;
+                }
+                pool->chunks = grown;
+                pool->maxChunks = maxChunks;
+            }
+            char* chunk = (char*)malloc(LABELS_PER_CHUNK * pool->labelSize);
+            if (chunk == NULL) {
+                return NULL;
+            }
+            pool->chunks[pool->numChunks++] = chunk;
+            pool->numUsed = 0;
+        }
+        label = (Label*)(pool->chunks[pool->numChunks - 1] + pool->numUsed++ * pool->labelSize);
+    }
+    pool->numLive++;
+    if (pool->numLive > pool->peakLive) {
+        pool->peakLive = pool->numLive;
+    }
+    return label;
+}
+
+static void releaseLabel(LabelPool* pool, Label* label) {
+    label->next = pool->freeList;
+    pool->freeList = label;
+    pool->numLive--;
+}
+
+/*************************************************************************
+ ** Queue
+ *************************************************************************/
+
+static bool queuePush(Queue* queue, long long key, int vertex, Label* label) {
+    if (queue->size == queue->capacity) {
+        int capacity = queue->capacity > 0 ? 2 * queue->capacity : 64;
+        QueueEntry* grown = (QueueEntry*)realloc(queue->entries,
+                                                 capacity * sizeof(QueueEntry));
+        if (grown == NULL) {
+            return false;
+        }
+        queue->entries = grown;
+        queue->capacity = capacity;
+    }
+    // move the hole up instead of swapping at every level
+    int hole = queue->size++;
+    while (hole > 0 && queue->entries[(hole - 1) / 2].key > key) {
+        queue->entries[hole] = queue->entries[(hole - 1) / 2];
+        hole = (hole - 1) / 2;
+    }
+    queue->entries[hole].key = key;
+    queue->entries[hole].vertex = vertex;
+    queue->entries[hole].label = label;
+    return true;
+}
+
+static QueueEntry queuePop(Queue* queue) {
+    QueueEntry top = queue->entries[0];
+    QueueEntry last = queue->entries[--queue->size];
+    int hole = 0;
+    for (;;) {
+        int child = 2 * hole + 1;
+        if (child >= queue->size) {
+            break;
+        }
+        if (child + 1 < queue->size && queue->entries[child + 1].key < queue->entries[child].key) {
+            child++;
+        }
+        if (queue->entries[child].key >= last.key) {
+            break;
+        }
+        queue->entries[hole] = queue->entries[child];
+        hole = child;
+    }
+    if (queue->size > 0) {
+        queue->entries[hole] = last;
+    }
+    return top;
+}
+
+/*************************************************************************
+ ** Lower bounds
+ *************************************************************************/
+
+/*
+ * Returns true iff 'edge' meets every CONSTRAINT_EDGE_MIN constraint.
+ */
+static bool isUsable(Graph* graph, Edge* edge, const Constraint* constraints) {
+    if (constraints == NULL || graph->numCosts == 0) {
+        return true;
+    }
+    int* costs = ((CostEdge*)edge)->costs;
+    for (int k = 0; k < graph->numCosts; k++) {
+        if (constraints[k].kind == CONSTRAINT_EDGE_MIN && costs[k] < constraints[k].bound) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Fills 'reverse' with the usable edges of 'graph'. Returns false on
+ * allocation failure or if a usable edge has a negative weight or
+ * CONSTRAINT_SUM attribute.
+ */
+static bool buildReverseEdges(Graph* graph, const Constraint* constraints,
+                              ReverseEdges* reverse) {
+    int n = graph->numVertices;
+    reverse->offsets = (int*)calloc(n + 1, sizeof(int));
+    reverse->edges = NULL;
+    if (reverse->offsets == NULL) {
+        return false;
+    }
+    for (int u = 0; u < n; u++) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL;
+             adjList = adjList->next) {
+            Edge* edge = adjList->edge;
+            if (!isUsable(graph, edge, constraints)) {
+                continue;
+            }
+            if (edge->weight < 0) {
+                return false;
+            }
+            for (int k = 0; constraints != NULL && k < graph->numCosts; k++) {
+                if (constraints[k].kind == CONSTRAINT_SUM && ((CostEdge*)edge)->costs[k] < 0) {
+                    return false;
+                }
+            }
+            reverse->offsets[edge->toVertex + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        reverse->offsets[v + 1] += reverse->offsets[v];
+    }
+    reverse->edges = (Edge**)malloc((reverse->offsets[n] + 1) * sizeof(Edge*));
+    int* fill = (int*)malloc(n * sizeof(int));
+    if (reverse->edges == NULL || fill == NULL) {
+        free(fill);
+        return false;
+    }
+    memcpy(fill, reverse->offsets, n * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL;
+             adjList = adjList->next) {
+            if (isUsable(graph, adjList->edge, constraints)) {
+                reverse->edges[fill[adjList->edge->toVertex]++] = adjList->edge;
+            }
+        }
+    }
+    free(fill);
+    return true;
+}
+
+/*
+ * Runs Dijkstra backwards from 'targetVertex' over 'reverse', costing
+ * edges by attribute 'attribute' or by weight if it is -1, and stores
+ * in bounds[v] the least cost of a path from v to 'targetVertex', or
+ * UNREACHABLE. Returns false on allocation failure.
+ */
+static bool getLowerBounds(Graph* graph, ReverseEdges* reverse, int targetVertex,
+                           int attribute, long long* bounds, Queue* queue) {
+    for (int v = 0; v < graph->numVertices; v++) {
+        bounds[v] = UNREACHABLE;
+    }
+    queue->size = 0;
+    bounds[targetVertex] = 0;
+    if (!queuePush(queue, 0, targetVertex, NULL)) {
+        return false;
+    }
+    while (queue->size > 0) {
+        QueueEntry top = queuePop(queue);
+        int v = top.vertex;
+        if (top.key > bounds[v]) {
+            continue;  // stale entry
+        }
+        for (int i = reverse->offsets[v]; i < reverse->offsets[v + 1]; i++) {
+            Edge* edge = reverse->edges[i];
+            int cost = attribute == -1 ? edge->weight : ((CostEdge*)edge)->costs[attribute];
+            long long bound = top.key + cost;
+            if (bound < bounds[edge->fromVertex]) {
+                bounds[edge->fromVertex] = bound;
+                if (!queuePush(queue, bound, edge->fromVertex, NULL)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/*************************************************************************
+ ** Search
+ *************************************************************************/
+
+/*
+ * Returns true iff 'label' is no worse than ('weight', 'totals') in
+ * every respect.
+ */
+static bool isAsGood(Label* label, long long weight, const int* totals, int numTotals) {
+    if (label->weight > weight) {
+        return false;
+    }
+    for (int s = 0; s < numTotals; s++) {
+        if (label->totals[s] > totals[s]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Returns true iff ('weight', 'totals') is no worse than 'label' in
+ * every respect.
+ */
+static bool isNoWorse(Label* label, long long weight, const int* totals, int numTotals) {
+    if (weight > label->weight) {
+        return false;
+    }
+    for (int s = 0; s < numTotals; s++) {
+        if (totals[s] > label->totals[s]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Builds the path of 'label' in makePath order. Returns NULL on
+ * allocation failure.
+ */
+static EdgeList* makeLabelPath(Label* label) {
+    EdgeList* path = NULL;
+    EdgeList* tail = NULL;
+    // paths are calloc'd, whatever the caller's current arena is
+    Arena* previous = setCurrentArena(NULL);
+    for (; label->previous != NULL; label = label->previous) {
+        Edge* edge = newEdge(label->vertex, label->previous->vertex, label->edge->weight);
+        EdgeList* node = (edge == NULL) ? NULL : newEdgeList(edge, NULL);
+        if (node == NULL) {
+            arenaFree(edge);
+            deleteEdgeList(path);
+            setCurrentArena(previous);
+            return NULL;
+        }
+        if (tail == NULL) {
+            path = node;
+        } else {
+            tail->next = node;
+        }
+        tail = node;
+    }
+    setCurrentArena(previous);
+    return path;
+}
+
+EdgeList* getConstrainedShortestPath(Graph* graph, int startVertex, int targetVertex,
+                                     const Constraint* constraints, int maxLabels,
+                                     ConstrainedStats* stats) {
+    ConstrainedStats counts;
+    memset(&counts, 0, sizeof(counts));
+    if (stats != NULL) {
+        *stats = counts;
+    }
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    int numCosts = constraints != NULL ? graph->numCosts : 0;
+    // sumAttributes[s] is the attribute whose total is label->totals[s]
+    int* sumAttributes = (int*)malloc((numCosts + 1) * sizeof(int));
+    int* totals = (int*)malloc((numCosts + 1) * sizeof(int));
+    if (sumAttributes == NULL || totals == NULL) {
+        free(sumAttributes);
+        free(totals);
+        return NULL;
+    }
+    int numTotals = 0;
+    for (int k = 0; k < numCosts; k++) {
+        if (constraints[k].kind == CONSTRAINT_SUM) {
+            sumAttributes[numTotals++] = k;
+        }
+    }
+
+    ReverseEdges reverse;
+    Queue queue = {NULL, 0, 0};
+    long long* lowerWeights = (long long*)malloc(n * sizeof(long long));
+    long long* lowerTotals = (long long*)malloc(((size_t)numTotals * n + 1) * sizeof(long long));
+    Label** labelsAt = (Label**)calloc(n, sizeof(Label*));
+    LabelPool pool;
+    initLabelPool(&pool, numTotals, maxLabels);
+    bool ok = buildReverseEdges(graph, constraints, &reverse) && lowerWeights != NULL &&
+              lowerTotals != NULL && labelsAt != NULL &&
+              getLowerBounds(graph, &reverse, targetVertex, -1, lowerWeights, &queue);
+    for (int s = 0; ok && s < numTotals; s++) {
+        ok = getLowerBounds(graph, &reverse, targetVertex, sumAttributes[s],
+                            lowerTotals + (size_t)s * n, &queue);
+    }
+    // the start can reach the target within every budget, as far as
+    // the bounds can tell
+    bool feasible = ok && lowerWeights[startVertex] != UNREACHABLE;
+    for (int s = 0; feasible && s < numTotals; s++) {
+        feasible = lowerTotals[(size_t)s * n + startVertex] <=
+                   constraints[sumAttributes[s]].bound;
+    }
+
+    Label* found = NULL;
+    Label* start = feasible ? allocLabel(&pool) : NULL;
+    queue.size = 0;
+    if (start != NULL) {
+        memset(start, 0, pool.labelSize);
+        start->vertex = startVertex;
+        labelsAt[startVertex] = start;
+        counts.labelsCreated++;
+        ok = queuePush(&queue, lowerWeights[startVertex], startVertex, start);
+    }
+    while (start != NULL && ok && queue.size > 0) {
+        Label* label = queuePop(&queue).label;
+        if (label->dead) {
+            releaseLabel(&pool, label);
+            continue;
+        }
+        label->settled = true;
+        counts.labelsSettled++;
+        if (label->vertex == targetVertex) {
+            found = label;
+            break;
+        }
+        for (EdgeList* adjList = graph->vertices[label->vertex]->adjList;
+             ok && adjList != NULL; adjList = adjList->next) {
+            Edge* edge = adjList->edge;
+            int v = edge->toVertex;
+            if (!isUsable(graph, edge, constraints)) {
+                continue;
+            }
+            long long weight = label->weight + edge->weight;
+            bool pruned = lowerWeights[v] == UNREACHABLE;
+            for (int s = 0; !pruned && s < numTotals; s++) {
+                int k = sumAttributes[s];
+                long long total = (long long)label->totals[s] + ((CostEdge*)edge)->costs[k];
+                pruned = total + lowerTotals[(size_t)s * n + v] > constraints[k].bound;
+                totals[s] = (int)total;
+            }
+            if (pruned) {
+                counts.labelsPruned++;
+                continue;
+            }
+            // drop the new label if one at v is as good; drop the queued
+            // labels at v it is as good as
+            bool dominated = false;
+            Label** link = &labelsAt[v];
+            while (*link != NULL) {
+                Label* other = *link;
+                if (isAsGood(other, weight, totals, numTotals)) {
+                    dominated = true;
+                    break;
+                }
+                if (!other->settled && isNoWorse(other, weight, totals, numTotals)) {
+                    other->dead = true;
+                    *link = other->next;
+                    counts.labelsDominated++;
+                } else {
+                    link = &other->next;
+                }
+            }
+            if (dominated) {
+                counts.labelsDominated++;
+                continue;
+            }
+            Label* next = allocLabel(&pool);
+            if (next == NULL) {
+                counts.exhausted = maxLabels > 0 && pool.numLive >= maxLabels;
+                ok = false;
+                break;
+            }
+            next->weight = weight;
+            next->vertex = v;
+            next->settled = false;
+            next->dead = false;
+            next->edge = edge;
+            next->previous = label;
+            memcpy(next->totals, totals, numTotals * sizeof(int));
+            next->next = labelsAt[v];
+            labelsAt[v] = next;
+            counts.labelsCreated++;
+            ok = queuePush(&queue, weight + lowerWeights[v], v, next);
+        }
+    }
+
+    EdgeList* path = found != NULL ? makeLabelPath(found) : NULL;
+    counts.peakLabels = pool.peakLive;
+    if (stats != NULL) {
+        *stats = counts;
+    }
+    freeLabelPool(&pool);
+    free(queue.entries);
+    free(reverse.offsets);
+    free(reverse.edges);
+    free(lowerWeights);
+    free(lowerTotals);
+    free(labelsAt);
+    free(sumAttributes);
+    free(totals);
+    return path;
+}
@@ -0,0 +1,63 @@
+/*
+ * Resource-constrained shortest paths.
+ *
+ * Finds the path of least weight whose cost attributes (see CostEdge)
+ * stay within bounds: a total toll budget, or a clearance every road
+ * must have for a truck. Unlike plain Dijkstra, a vertex can be reached
+ * by several paths none of which is better in every respect, so the
+ * search keeps a label (weight, resource totals) per such path and only
+ * drops a label when another at the same vertex is at least as good in
+ * every respect, or when lower bounds show it cannot end within the
+ * budgets.
+ */
+
+#ifndef CONSTRAINED_H
+#define CONSTRAINED_H
+
+#include <stdbool.h>
+#include "graph.h"
+
+typedef enum constraintKind
+{
+  CONSTRAINT_NONE,      // the attribute is ignored
+  CONSTRAINT_SUM,       // its total along the path is at most 'bound'
+  CONSTRAINT_EDGE_MIN   // every edge on the path has at least 'bound',
+                        //   e.g. a road's clearance against a height
+} ConstraintKind;
+
+typedef struct constraint
+{
+  ConstraintKind kind;
+  int bound;
+} Constraint;
+
+typedef struct constrainedStats
+{
+  long labelsCreated;    // labels allocated, the start's included
+  long labelsDominated;  // dropped for a label at least as good
+  long labelsPruned;     // dropped because no completion fits the budgets
+  long labelsSettled;    // taken off the queue and expanded
+  long peakLabels;       // most labels held at once
+  bool exhausted;        // the search stopped at maxLabels
+} ConstrainedStats;
+
+/*
+ * Returns the path of least weight from 'startVertex' to 'targetVertex'
+ * that meets constraints[k] for every cost attribute k of 'graph'
+ * (graph->numCosts entries; NULL constrains nothing), in the order of
+ * getShortestPath: the first edge leaves 'targetVertex'. Weights and
+ * the attributes under CONSTRAINT_SUM must be non-negative.
+ *
+ * Labels come from a pool that reuses the memory of dropped ones. If
+ * 'maxLabels' > 0, at most that many are held at once; a search that
+ * needs more stops and returns NULL with stats->exhausted set. If
+ * 'stats' is not NULL the counters of the search are stored there.
+ *
+ * Returns NULL if no path meets the constraints, if 'targetVertex'
+ * equals 'startVertex', on invalid arguments or on allocation failure.
+ */
+EdgeList* getConstrainedShortestPath(Graph* graph, int startVertex, int targetVertex,
+                                     const Constraint* constraints, int maxLabels,
+                                     ConstrainedStats* stats);
+
+#endif
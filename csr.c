@@ -0,0 +1,276 @@
+/*
+ * CSR graph representation and the algorithms that run on it.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "csr.h"
+#include "minheap.h"
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+/*
+ * Allocates a CSRGraph with room for 'numVertices' vertices and
+ * 'numEdges' edges. offsets is zeroed.
+ */
+static CSRGraph* allocCSRGraph(int numVertices, int numEdges) {
+    CSRGraph* csr = (CSRGraph*)calloc(1, sizeof(CSRGraph));
+    if (csr == NULL) {
+        return NULL;
+    }
+    csr->numVertices = numVertices;
+    csr->numEdges = numEdges;
+    csr->offsets = (int*)calloc(numVertices + 1, sizeof(int));
+    // +1 so that an edgeless graph still gets non-NULL arrays
+    csr->targets = (int*)malloc((numEdges + 1) * sizeof(int));
+    csr->weights = (int*)malloc((numEdges + 1) * sizeof(int));
+    if (csr->offsets == NULL || csr->targets == NULL || csr->weights == NULL) {
+        deleteCSRGraph(csr);
+        return NULL;
+    }
+    return csr;
+}
+
+/*************************************************************************
+ ** Construction and destruction
+ *************************************************************************/
+
+CSRGraph* newCSRGraph(Graph* graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    // count edges ourselves rather than trusting graph->numEdges
+    int numEdges = 0;
+    for (int u = 0; u < graph->numVertices; u++) {
+        for (EdgeList* adj = graph->vertices[u]->adjList; adj != NULL; adj = adj->next) {
+            numEdges++;
+        }
+    }
+    CSRGraph* csr = allocCSRGraph(graph->numVertices, numEdges);
+    if (csr == NULL) {
+        return NULL;
+    }
+    int pos = 0;
+    for (int u = 0; u < graph->numVertices; u++) {
+        csr->offsets[u] = pos;
+        for (EdgeList* adj = graph->vertices[u]->adjList; adj != NULL; adj = adj->next) {
+            csr->targets[pos] = adj->edge->toVertex;
+            csr->weights[pos] = adj->edge->weight;
+            pos++;
+        }
+    }
+    csr->offsets[graph->numVertices] = pos;
+    return csr;
+}
+
+CSRGraph* newCSRGraphFromEdges(int numVertices, Edge* edges, int numEdges) {
+    if (numVertices <= 0 || numEdges < 0 || (edges == NULL && numEdges > 0)) {
+        return NULL;
+    }
+    int numValid = 0;
+    for (int i = 0; i < numEdges; i++) {
+        if (edges[i].fromVertex >= 0 && edges[i].fromVertex < numVertices &&
+            edges[i].toVertex >= 0 && edges[i].toVertex < numVertices) {
+            numValid++;
+        }
+    }
+    CSRGraph* csr = allocCSRGraph(numVertices, numValid);
+    if (csr == NULL) {
+        return NULL;
+    }
+    // counting sort by fromVertex: degrees, prefix sums, then scatter
+    for (int i = 0; i < numEdges; i++) {
+        if (edges[i].fromVertex >= 0 && edges[i].fromVertex < numVertices &&
+            edges[i].toVertex >= 0 && edges[i].toVertex < numVertices) {
+            csr->offsets[edges[i].fromVertex + 1]++;
+        }
+    }
+    for (int u = 0; u < numVertices; u++) {
+        csr->offsets[u + 1] += csr->offsets[u];
+    }
+    int* next = (int*)malloc(numVertices * sizeof(int));
+    if (next == NULL) {
+        deleteCSRGraph(csr);
+        return NULL;
+    }
+    for (int u = 0; u < numVertices; u++) {
+        next[u] = csr->offsets[u];
+    }
+    for (int i = 0; i < numEdges; i++) {
+        int u = edges[i].fromVertex;
+        int v = edges[i].toVertex;
+        if (u >= 0 && u < numVertices && v >= 0 && v < numVertices) {
+            csr->targets[next[u]] = v;
+            csr->weights[next[u]] = edges[i].weight;
+            next[u]++;
+        }
+    }
+    free(next);
+    return csr;
+}
+
+void deleteCSRGraph(CSRGraph* csr) {
+    if (!csr) return;
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->weights);
+    free(csr);
+}
+
+/*************************************************************************
+ ** Memory footprint
+ *************************************************************************/
+
+size_t csrGraphBytes(CSRGraph* csr, size_t* numAllocs) {
+    if (numAllocs != NULL) {
+        *numAllocs = (csr == NULL) ? 0 : 4;
+    }
+    if (csr == NULL) {
+        return 0;
+    }
+    return sizeof(CSRGraph) +
+           (size_t)(csr->numVertices + 1) * sizeof(int) +
+           (size_t)(csr->numEdges + 1) * 2 * sizeof(int);
+}
+
+size_t graphBytes(Graph* graph, size_t* numAllocs) {
+    if (numAllocs != NULL) {
+        *numAllocs = 0;
+    }
+    if (graph == NULL) {
+        return 0;
+    }
+    size_t numEdges = 0;
+    for (int u = 0; u < graph->numVertices; u++) {
+        for (EdgeList* adj = graph->vertices[u]->adjList; adj != NULL; adj = adj->next) {
+            numEdges++;
+        }
+    }
+    if (numAllocs != NULL) {
+        // Graph, vertices array, one Vertex each, one EdgeList + Edge each
+        *numAllocs = 2 + (size_t)graph->numVertices + 2 * numEdges;
+    }
+    return sizeof(Graph) +
+           (size_t)graph->numVertices * (sizeof(Vertex*) + sizeof(Vertex)) +
+           numEdges * (sizeof(EdgeList) + sizeof(Edge));
+}
+
+void printCSRFootprint(CSRGraph* csr, Graph* graph) {
+    size_t csrAllocs, graphAllocs;
+    size_t csrSize = csrGraphBytes(csr, &csrAllocs);
+    size_t graphSize = graphBytes(graph, &graphAllocs);
+    printf("Linked graph: %zu bytes in %zu allocations.\n", graphSize, graphAllocs);
+    printf("CSR graph:    %zu bytes in %zu allocations.\n", csrSize, csrAllocs);
+    if (csrSize > 0) {
+        printf("Ratio: %.2fx\n", (double)graphSize / (double)csrSize);
+    }
+}
+
+/*************************************************************************
+ ** Algorithms
+ *************************************************************************/
+
+Edge* getDistanceTreeDijkstraCSR(CSRGraph* csr, int startVertex) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices) {
+        return NULL;
+    }
+    int n = csr->numVertices;
+    MinHeap* heap = newHeap(n);
+    bool* finished = (bool*)calloc(n, sizeof(bool));
+    int* distances = (int*)malloc(n * sizeof(int));
+    Edge* distTree = (Edge*)calloc(n, sizeof(Edge));
+    if (heap == NULL || finished == NULL || distances == NULL || distTree == NULL) {
+        deleteHeap(heap);
+        free(finished);
+        free(distances);
+        free(distTree);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        distances[i] = INT_MAX;
+    }
+    distances[startVertex] = 0;
+    insert(heap, 0, startVertex);
+    while (heap->size > 0) {
+        HeapNode minNode = extractMin(heap);
+        int u = minNode.id;
+        finished[u] = true;
+        int du = distances[u];
+        for (int i = csr->offsets[u]; i < csr->offsets[u + 1]; i++) {
+            int v = csr->targets[i];
+            int distance = addDistance(du, csr->weights[i]);
+            if (!finished[v] && distance < distances[v]) {
+                decreaseOrInsert(heap, v, distance);
+                distances[v] = distance;
+                distTree[v].fromVertex = u;
+                distTree[v].toVertex = v;
+                distTree[v].weight = distance;
+            }
+        }
+    }
+    // to match getDistanceTreeDijkstra
+    distTree[startVertex].fromVertex = startVertex;
+    distTree[startVertex].toVertex = startVertex;
+    distTree[startVertex].weight = 0;
+    deleteHeap(heap);
+    free(finished);
+    free(distances);
+    return distTree;
+}
+
+Edge* getMSTprimCSR(CSRGraph* csr, int startVertex) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices) {
+        return NULL;
+    }
+    int n = csr->numVertices;
+    MinHeap* heap = newHeap(n);
+    bool* finished = (bool*)calloc(n, sizeof(bool));
+    int* keys = (int*)malloc(n * sizeof(int));
+    int* predecessors = (int*)malloc(n * sizeof(int));
+    // a spanning tree has at most numVertices-1 edges
+    Edge* tree = (Edge*)calloc(n, sizeof(Edge));
+    if (heap == NULL || finished == NULL || keys == NULL ||
+        predecessors == NULL || tree == NULL) {
+        deleteHeap(heap);
+        free(finished);
+        free(keys);
+        free(predecessors);
+        free(tree);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        keys[i] = INT_MAX;
+        predecessors[i] = -1;
+    }
+    keys[startVertex] = 0;
+    insert(heap, 0, startVertex);
+    int numTreeEdges = 0;
+    while (heap->size > 0) {
+        HeapNode minNode = extractMin(heap);
+        int u = minNode.id;
+        finished[u] = true;
+        if (predecessors[u] != -1) {
+            tree[numTreeEdges].fromVertex = u;
+            tree[numTreeEdges].toVertex = predecessors[u];
+            tree[numTreeEdges].weight = minNode.priority;
+            numTreeEdges++;
+        }
+        for (int i = csr->offsets[u]; i < csr->offsets[u + 1]; i++) {
+            int v = csr->targets[i];
+            int weight = csr->weights[i];
+            if (!finished[v] && weight < keys[v]) {
+                decreaseOrInsert(heap, v, weight);
+                keys[v] = weight;
+                predecessors[v] = u;
+            }
+        }
+    }
+    deleteHeap(heap);
+    free(finished);
+    free(keys);
+    free(predecessors);
+    return tree;
+}
@@ -0,0 +1,65 @@
+/*
+ * Compressed sparse row (CSR) graph representation.
+ *
+ * A CSRGraph is a frozen, read-only copy of a Graph: the out-edges of
+ * vertex u are targets[offsets[u] .. offsets[u+1]-1] with matching
+ * weights, so a relaxation loop walks two contiguous arrays instead of
+ * chasing EdgeList and Edge pointers.
+ */
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <stddef.h>
+#include "graph.h"
+
+typedef struct csrGraph
+{
+  int numVertices;  // vertex IDs are 0, 1, ..., numVertices-1
+  int numEdges;     // number of directed edges stored
+  int* offsets;     // numVertices+1 entries, offsets[numVertices] == numEdges
+  int* targets;     // targets[i] is the toVertex of the i-th edge
+  int* weights;     // weights[i] is the weight of the i-th edge
+} CSRGraph;
+
+/*
+ * Creates and returns a CSRGraph holding the same edges as 'graph'.
+ * Edges of each vertex keep their adjList order.
+ * Returns NULL if 'graph' is NULL or on allocation failure.
+ */
+CSRGraph* newCSRGraph(Graph* graph);
+
+/*
+ * Creates and returns a CSRGraph on 'numVertices' vertices from the
+ * 'numEdges' edges in 'edges'. Edges with an endpoint outside
+ * 0..numVertices-1 are ignored.
+ * Returns NULL on invalid arguments or allocation failure.
+ */
+CSRGraph* newCSRGraphFromEdges(int numVertices, Edge* edges, int numEdges);
+
+void deleteCSRGraph(CSRGraph* csr);
+
+/*
+ * Returns the number of bytes used by 'csr' / 'graph', counting the
+ * structure itself and every array or node it owns (vertex payloads
+ * are not counted). If 'numAllocs' is not NULL, the number of separate
+ * heap allocations is stored there.
+ */
+size_t csrGraphBytes(CSRGraph* csr, size_t* numAllocs);
+size_t graphBytes(Graph* graph, size_t* numAllocs);
+
+/*
+ * Prints the memory footprint of 'csr' next to that of the linked
+ * 'graph' it was built from.
+ */
+void printCSRFootprint(CSRGraph* csr, Graph* graph);
+
+/*
+ * Same as getDistanceTreeDijkstra and getMSTprim, but running on 'csr'.
+ * The returned Edge arrays have the same layout as their Graph
+ * counterparts.
+ */
+Edge* getDistanceTreeDijkstraCSR(CSRGraph* csr, int startVertex);
+Edge* getMSTprimCSR(CSRGraph* csr, int startVertex);
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ * Delta-stepping single-source shortest paths.
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "barrier.h"
+#include "deltastep.h"
+
+// buckets live at once are kept in a ring of at most this many slots;
+// delta is raised if the maximum weight would need more
+#define MAX_BUCKET_SLOTS (1 << 20)
+
+// a distance and the predecessor it came from, packed so that both are
+// updated by one compare-and-swap: distance in the high 32 bits
+#define PACK(distance, pred) (((uint64_t)(uint32_t)(distance) << 32) | (uint32_t)(pred))
+#define DISTANCE_OF(packed) ((int)((packed) >> 32))
+#define PRED_OF(packed) ((int)(uint32_t)(packed))
+#define UNREACHED PACK(INT_MAX, -1)
+
+typedef enum phase
+{
+  PHASE_LIGHT,
+  PHASE_HEAVY,
+  PHASE_DONE
+} Phase;
+
+/*
+ * A growable array of ints.
+ */
+typedef struct intArray
+{
+  int size;
+  int capacity;
+  int* arr;
+} IntArray;
+
+/*
+ * A vertex whose distance a thread lowered, with its new bucket.
+ */
+typedef struct request
+{
+  int vertex;
+  int bucket;
+} Request;
+
+typedef struct requestArray
+{
+  int size;
+  int capacity;
+  Request* arr;
+} RequestArray;
+
+/*
+ * State shared by the threads of one delta-stepping run. Everything but
+ * 'distances' and the per-thread 'requests' is only written by thread 0
+ * between barriers.
+ */
+typedef struct deltaJob
+{
+  CSRGraph* csr;
+  int delta;
+  int numThreads;
+  _Atomic uint64_t* distances;  // packed distance and predecessor
+  Barrier barrier;
+  Phase phase;
+  IntArray frontier;            // vertices to scan in this phase
+  RequestArray* requests;       // requests[t] is filled by thread t
+  atomic_bool failed;           // allocation failed, stop everything
+  // the rest is thread 0 only
+  int current;                  // index of the bucket being emptied
+  IntArray* slots;              // ring of buckets, bucket b in slot b % numSlots
+  int numSlots;
+  IntArray settled;             // vertices scanned in the current bucket
+  int* frontierMark;            // frontierMark[v] == phaseStamp iff v is in frontier
+  int* settledMark;             // settledMark[v] == bucketStamp iff v is in settled
+  int phaseStamp;
+  int bucketStamp;
+} DeltaJob;
+
+typedef struct workerArg
+{
+  DeltaJob* job;
+  int id;
+} WorkerArg;
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+static bool intArrayPush(IntArray* a, int value) {
+    if (a->size == a->capacity) {
+        int newCapacity = a->capacity == 0 ? 16 : 2 * a->capacity;
+        int* arr = (int*)realloc(a->arr, newCapacity * sizeof(int));
+        if (arr == NULL) {
+            return false;
+        }
+        a->arr = arr;
+        a->capacity = newCapacity;
+    }
+    a->arr[a->size++] = value;
+    return true;
+}
+
+static bool requestArrayPush(RequestArray* a, int vertex, int bucket) {
+    if (a->size == a->capacity) {
+        int newCapacity = a->capacity == 0 ? 64 : 2 * a->capacity;
+        Request* arr = (Request*)realloc(a->arr, newCapacity * sizeof(Request));
+        if (arr == NULL) {
+            return false;
+        }
+        a->arr = arr;
+        a->capacity = newCapacity;
+    }
+    a->arr[a->size].vertex = vertex;
+    a->arr[a->size].bucket = bucket;
+    a->size++;
+    return true;
+}
+
+/*
+ * Lowers the distance in 'slot' to 'distance' through 'pred' unless it
+ * is already at most 'distance'. Returns true iff it was lowered.
+ */
+static bool atomicRelax(_Atomic uint64_t* slot, int distance, int pred) {
+    uint64_t desired = PACK(distance, pred);
+    uint64_t seen = atomic_load_explicit(slot, memory_order_relaxed);
+    while (DISTANCE_OF(seen) > distance) {
+        if (atomic_compare_exchange_weak_explicit(slot, &seen, desired,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*************************************************************************
+ ** Worker threads
+ *************************************************************************/
+
+/*
+ * Relaxes the light or heavy edges of this thread's share of the
+ * frontier, recording every lowered vertex in job->requests[id].
+ */
+static void relaxShare(DeltaJob* job, int id) {
+    CSRGraph* csr = job->csr;
+    bool light = job->phase == PHASE_LIGHT;
+    int size = job->frontier.size;
+    int from = (int)((long)size * id / job->numThreads);
+    int to = (int)((long)size * (id + 1) / job->numThreads);
+    RequestArray* requests = &job->requests[id];
+    for (int i = from; i < to; i++) {
+        int u = job->frontier.arr[i];
+        int du = DISTANCE_OF(atomic_load_explicit(&job->distances[u], memory_order_relaxed));
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            int weight = csr->weights[e];
+            if ((weight <= job->delta) != light) {
+                continue;
+            }
+            long candidate = (long)du + weight;
+            if (candidate >= INT_MAX) {
+                continue;
+            }
+            int v = csr->targets[e];
+            if (atomicRelax(&job->distances[v], (int)candidate, u) &&
+                !requestArrayPush(requests, v, (int)(candidate / job->delta))) {
+                atomic_store(&job->failed, true);
+            }
+        }
+    }
+}
+
+/*
+ * Adds 'v' to the frontier of the next phase unless it is already there.
+ */
+static bool addToFrontier(DeltaJob* job, int v) {
+    if (job->frontierMark[v] == job->phaseStamp) {
+        return true;
+    }
+    job->frontierMark[v] = job->phaseStamp;
+    return intArrayPush(&job->frontier, v);
+}
+
+/*
+ * Moves to the next non-empty bucket after job->current and fills the
+ * frontier with its live vertices. Returns false if there is none.
+ */
+static bool advanceBucket(DeltaJob* job) {
+    int last = job->current;
+    for (int step = 1; step <= job->numSlots; step++) {
+        int bucket = last + step;
+        IntArray* slot = &job->slots[bucket % job->numSlots];
+        if (slot->size == 0) {
+            continue;
+        }
+        job->current = bucket;
+        job->bucketStamp++;
+        job->phaseStamp++;
+        job->frontier.size = 0;
+        job->settled.size = 0;
+        for (int i = 0; i < slot->size; i++) {
+            int v = slot->arr[i];
+            int dv = DISTANCE_OF(atomic_load_explicit(&job->distances[v], memory_order_relaxed));
+            // entries whose distance has since dropped to an earlier bucket
+            // were already handled there
+            if (dv / job->delta == bucket && !addToFrontier(job, v)) {
+                atomic_store(&job->failed, true);
+            }
+        }
+        slot->size = 0;
+        if (job->frontier.size > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Run by thread 0 between barriers: collects every thread's requests and
+ * decides what the next phase works on.
+ */
+static void planNextPhase(DeltaJob* job) {
+    if (job->phase == PHASE_LIGHT) {
+        // everything just scanned is settled in this bucket unless it
+        // comes back through a request below
+        for (int i = 0; i < job->frontier.size; i++) {
+            int v = job->frontier.arr[i];
+            if (job->settledMark[v] != job->bucketStamp) {
+                job->settledMark[v] = job->bucketStamp;
+                if (!intArrayPush(&job->settled, v)) {
+                    atomic_store(&job->failed, true);
+                }
+            }
+        }
+    }
+    job->phaseStamp++;
+    job->frontier.size = 0;
+    for (int t = 0; t < job->numThreads; t++) {
+        RequestArray* requests = &job->requests[t];
+        for (int i = 0; i < requests->size; i++) {
+            Request r = requests->arr[i];
+            bool ok = (r.bucket == job->current)
+                ? addToFrontier(job, r.vertex)
+                : intArrayPush(&job->slots[r.bucket % job->numSlots], r.vertex);
+            if (!ok) {
+                atomic_store(&job->failed, true);
+            }
+        }
+        requests->size = 0;
+    }
+    if (atomic_load(&job->failed)) {
+        job->phase = PHASE_DONE;
+    } else if (job->phase == PHASE_LIGHT && job->frontier.size > 0) {
+        job->phase = PHASE_LIGHT;  // light edges reinserted into this bucket
+    } else if (job->phase == PHASE_LIGHT) {
+        job->phase = PHASE_HEAVY;
+        IntArray swap = job->frontier;
+        job->frontier = job->settled;
+        job->settled = swap;
+    } else {
+        job->phase = advanceBucket(job) ? PHASE_LIGHT : PHASE_DONE;
+    }
+}
+
+static void* deltaWorker(void* arg) {
+    DeltaJob* job = ((WorkerArg*)arg)->job;
+    int id = ((WorkerArg*)arg)->id;
+    for (;;) {
+        barrierWait(&job->barrier);
+        if (job->phase == PHASE_DONE) {
+            break;
+        }
+        relaxShare(job, id);
+        barrierWait(&job->barrier);
+        if (id == 0) {
+            planNextPhase(job);
+        }
+    }
+    return NULL;
+}
+
+/*************************************************************************
+ ** Public interface
+ *************************************************************************/
+
+static void freeDeltaJob(DeltaJob* job) {
+    free(job->distances);
+    free(job->frontier.arr);
+    free(job->settled.arr);
+    free(job->frontierMark);
+    free(job->settledMark);
+    if (job->requests != NULL) {
+        for (int t = 0; t < job->numThreads; t++) {
+            free(job->requests[t].arr);
+        }
+    }
+    free(job->requests);
+    if (job->slots != NULL) {
+        for (int i = 0; i < job->numSlots; i++) {
+            free(job->slots[i].arr);
+        }
+    }
+    free(job->slots);
+}
+
+Edge* getDistanceTreeDeltaSteppingCSR(CSRGraph* csr, int startVertex, int delta,
+                                      int numThreads) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices ||
+        numThreads <= 0) {
+        return NULL;
+    }
+    int n = csr->numVertices;
+    int maxWeight = 0;
+    for (int e = 0; e < csr->numEdges; e++) {
+        if (csr->weights[e] < 0) {
+            return NULL;
+        }
+        if (csr->weights[e] > maxWeight) {
+            maxWeight = csr->weights[e];
+        }
+    }
+    if (delta <= 0) {
+        int averageDegree = csr->numEdges / n > 0 ? csr->numEdges / n : 1;
+        delta = maxWeight / averageDegree > 0 ? maxWeight / averageDegree : 1;
+    }
+    if (maxWeight / delta + 2 > MAX_BUCKET_SLOTS) {
+        delta = maxWeight / (MAX_BUCKET_SLOTS - 2) + 1;
+    }
+
+    DeltaJob job = {0};
+    atomic_init(&job.failed, false);
+    job.csr = csr;
+    job.delta = delta;
+    job.numThreads = numThreads;
+    // a relaxation moves at most maxWeight / delta + 1 buckets ahead
+    job.numSlots = maxWeight / delta + 2;
+    job.distances = (_Atomic uint64_t*)malloc(n * sizeof(_Atomic uint64_t));
+    job.requests = (RequestArray*)calloc(numThreads, sizeof(RequestArray));
+    job.slots = (IntArray*)calloc(job.numSlots, sizeof(IntArray));
+    job.frontierMark = (int*)calloc(n, sizeof(int));
+    job.settledMark = (int*)calloc(n, sizeof(int));
+    Edge* distTree = (Edge*)calloc(n, sizeof(Edge));
+    WorkerArg* args = (WorkerArg*)malloc(numThreads * sizeof(WorkerArg));
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (job.distances == NULL || job.requests == NULL || job.slots == NULL ||
+        job.frontierMark == NULL || job.settledMark == NULL || distTree == NULL ||
+        args == NULL || threads == NULL) {
+        freeDeltaJob(&job);
+        free(distTree);
+        free(args);
+        free(threads);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        atomic_init(&job.distances[v], UNREACHED);
+    }
+    atomic_store(&job.distances[startVertex], PACK(0, -1));
+    job.current = -1;
+    job.phase = PHASE_LIGHT;
+    if (!intArrayPush(&job.slots[0], startVertex) || !advanceBucket(&job)) {
+        job.phase = PHASE_DONE;
+        atomic_store(&job.failed, true);
+    }
+
+    barrierInit(&job.barrier, numThreads);
+    int numStarted = 0;
+    for (int t = 1; t < numThreads; t++) {
+        args[t].job = &job;
+        args[t].id = t;
+        if (pthread_create(&threads[t], NULL, deltaWorker, &args[t]) != 0) {
+            break;
+        }
+        numStarted++;
+    }
+    // fewer threads than asked for is fine if some cannot be started; no
+    // barrier can complete before this thread arrives, so shrinking it
+    // now is safe
+    pthread_mutex_lock(&job.barrier.mutex);
+    job.barrier.count = numStarted + 1;
+    job.numThreads = numStarted + 1;
+    pthread_mutex_unlock(&job.barrier.mutex);
+    args[0].job = &job;
+    args[0].id = 0;
+    deltaWorker(&args[0]);
+    for (int t = 1; t <= numStarted; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    barrierDestroy(&job.barrier);
+
+    if (!atomic_load(&job.failed)) {
+        for (int v = 0; v < n; v++) {
+            uint64_t packed = atomic_load(&job.distances[v]);
+            if (packed != UNREACHED && v != startVertex) {
+                distTree[v].fromVertex = PRED_OF(packed);
+                distTree[v].toVertex = v;
+                distTree[v].weight = DISTANCE_OF(packed);
+            }
+        }
+        // to match getDistanceTreeDijkstra
+        distTree[startVertex].fromVertex = startVertex;
+        distTree[startVertex].toVertex = startVertex;
+        distTree[startVertex].weight = 0;
+    } else {
+        free(distTree);
+        distTree = NULL;
+    }
+    freeDeltaJob(&job);
+    free(args);
+    free(threads);
+    return distTree;
+}
+
+Edge* getDistanceTreeDeltaStepping(Graph* graph, int startVertex, int delta,
+                                   int numThreads) {
+    CSRGraph* csr = newCSRGraph(graph);
+    if (csr == NULL) {
+        return NULL;
+    }
+    Edge* distTree = getDistanceTreeDeltaSteppingCSR(csr, startVertex, delta, numThreads);
+    deleteCSRGraph(csr);
+    return distTree;
+}
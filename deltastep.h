@@ -0,0 +1,34 @@
+/*
+ * Parallel single-source shortest paths by delta-stepping.
+ *
+ * Vertices are kept in buckets of width 'delta' by tentative distance.
+ * The lowest non-empty bucket is emptied by repeatedly relaxing the light
+ * edges (weight <= delta) of its vertices, then the heavy edges of every
+ * vertex it settled are relaxed once. Each of these steps is split across
+ * threads, which lower distances with atomic compare-and-swap.
+ */
+
+#ifndef DELTASTEP_H
+#define DELTASTEP_H
+
+#include "graph.h"
+#include "csr.h"
+
+/*
+ * Same as getDistanceTreeDijkstra, but computed by delta-stepping on
+ * 'numThreads' threads (the calling thread included) with bucket width
+ * 'delta'. If 'delta' <= 0 a width is picked from the maximum weight and
+ * average degree. Edge weights must be non-negative.
+ * Returns NULL on invalid arguments, a negative weight, or allocation
+ * failure.
+ */
+Edge* getDistanceTreeDeltaSteppingCSR(CSRGraph* csr, int startVertex, int delta,
+                                      int numThreads);
+
+/*
+ * Same as getDistanceTreeDeltaSteppingCSR, on a CSR copy of 'graph'.
+ */
+Edge* getDistanceTreeDeltaStepping(Graph* graph, int startVertex, int delta,
+                                   int numThreads);
+
+#endif
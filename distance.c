@@ -0,0 +1,116 @@
+/*
+ * Dijkstra's algorithm with a choice of distance type.
+ */
+
+#include <stdlib.h>
+#include "distance.h"
+#include "search_queue.h"
+
+/*
+ * Defines the search for one distance type: 'Tree' is the result type
+ * (DistanceTree32, ...), 'Type' the distance type, 'INFINITY_VALUE' its
+ * unreachable value and 'ADD' its saturating addition. The queue is the
+ * lazy heap of search_queue.h: a vertex is pushed again whenever its
+ * distance drops, and entries that are out of date when they reach the
+ * top are skipped.
+ */
+#define DEFINE_DISTANCE_TREE(Tree, Type, INFINITY_VALUE, ADD)                          \
+                                                                                      \
+DEFINE_SEARCH_QUEUE_LAZY(Tree##Queue, Type)                                           \
+                                                                                      \
+void delete##Tree(Tree* tree) {                                                       \
+    if (!tree) return;                                                                \
+    free(tree->distances);                                                            \
+    free(tree->predecessors);                                                         \
+    free(tree);                                                                       \
+}                                                                                     \
+                                                                                      \
+static Tree* Tree##Run(Graph* graph, int startVertex, EdgeCost cost, void* data) {    \
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {      \
+        return NULL;                                                                  \
+    }                                                                                 \
+    int n = graph->numVertices;                                                       \
+    Tree* tree = (Tree*)calloc(1, sizeof(Tree));                                      \
+    if (tree == NULL) {                                                               \
+        return NULL;                                                                  \
+    }                                                                                 \
+    tree->numVertices = n;                                                            \
+    tree->startVertex = startVertex;                                                  \
+    tree->distances = (Type*)malloc(n * sizeof(Type));                                \
+    tree->predecessors = (int*)malloc(n * sizeof(int));                               \
+    Tree##Queue queue;                                                                \
+    if (!Tree##QueueInit(&queue, n)) {                                                \
+        delete##Tree(tree);                                                           \
+        return NULL;                                                                  \
+    }                                                                                 \
+    if (tree->distances == NULL || tree->predecessors == NULL ||                      \
+        !Tree##QueuePush(&queue, 0, startVertex)) {                                   \
+        Tree##QueueFree(&queue);                                                      \
+        delete##Tree(tree);                                                           \
+        return NULL;                                                                  \
+    }                                                                                 \
+    for (int i = 0; i < n; i++) {                                                     \
+        tree->distances[i] = INFINITY_VALUE;                                          \
+        tree->predecessors[i] = -1;                                                   \
+    }                                                                                 \
+    tree->distances[startVertex] = 0;                                                 \
+    while (!Tree##QueueIsEmpty(&queue)) {                                             \
+        Type key;                                                                     \
+        int u = Tree##QueuePop(&queue, &key);                                         \
+        if (key > tree->distances[u]) {                                               \
+            continue; /* stale entry */                                               \
+        }                                                                             \
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL;        \
+             adjList = adjList->next) {                                               \
+            Edge* edge = adjList->edge;                                               \
+            Type weight = cost != NULL ? (Type)cost(edge, data) : (Type)edge->weight; \
+            Type distance = ADD(key, weight);                                         \
+            int v = edge->toVertex;                                                   \
+            if (distance < tree->distances[v]) {                                      \
+                if (!Tree##QueuePush(&queue, distance, v)) {                          \
+                    Tree##QueueFree(&queue);                                          \
+                    delete##Tree(tree);                                               \
+                    return NULL;                                                      \
+                }                                                                     \
+                tree->distances[v] = distance;                                        \
+                tree->predecessors[v] = u;                                            \
+            }                                                                         \
+        }                                                                             \
+    }                                                                                 \
+    Tree##QueueFree(&queue);                                                          \
+    return tree;                                                                      \
+}
+
+
+DEFINE_DISTANCE_TREE(DistanceTree32, int32_t, DISTANCE32_INFINITY, addDistance)
+DEFINE_DISTANCE_TREE(DistanceTree64, int64_t, DISTANCE64_INFINITY, SEARCH_ADD_INT64)
+DEFINE_DISTANCE_TREE(DistanceTreeDouble, double, DISTANCE_DOUBLE_INFINITY,
+                     SEARCH_ADD_DOUBLE)
+
+DistanceTree32* getDistanceTree32(Graph* graph, int startVertex) {
+    return DistanceTree32Run(graph, startVertex, NULL, NULL);
+}
+
+DistanceTree64* getDistanceTree64(Graph* graph, int startVertex) {
+    return DistanceTree64Run(graph, startVertex, NULL, NULL);
+}
+
+DistanceTreeDouble* getDistanceTreeDouble(Graph* graph, int startVertex,
+                                          EdgeCost cost, void* data) {
+    return DistanceTreeDoubleRun(graph, startVertex, cost, data);
+}
+
+int64_t getMaxPathWeight(Graph* graph) {
+    if (graph == NULL || graph->numVertices == 0) {
+        return 0;
+    }
+    int64_t maxWeight = 0;
+    for (int u = 0; u < graph->numVertices; u++) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            if (adjList->edge->weight > maxWeight) {
+                maxWeight = adjList->edge->weight;
+            }
+        }
+    }
+    return (int64_t)(graph->numVertices - 1) * maxWeight;
+}
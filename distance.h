@@ -0,0 +1,84 @@
+/*
+ * Dijkstra's algorithm with a choice of distance type.
+ *
+ * The int searches of graph_algos.c treat INT_MAX as "unreached" and
+ * every distance that would reach it as unreachable, which is only right
+ * while all shortest paths weigh less than INT_MAX. The searches here
+ * share one engine instantiated for int32_t, int64_t and double
+ * distances, so the narrowest type that is safe for a graph can be
+ * picked (see getMaxPathWeight). Each type has a defined infinity for
+ * unreachable vertices, and integer sums saturate at it instead of
+ * overflowing.
+ */
+
+#ifndef DISTANCE_H
+#define DISTANCE_H
+
+#include <math.h>
+#include <stdint.h>
+#include "graph.h"
+
+#define DISTANCE32_INFINITY INT32_MAX
+#define DISTANCE64_INFINITY INT64_MAX
+#define DISTANCE_DOUBLE_INFINITY INFINITY
+
+/*
+ * Shortest path trees from 'startVertex'. distances[id] is the infinity
+ * of the type if id is unreachable; predecessors[id] is the previous
+ * vertex on the path to id, -1 for 'startVertex' and unreachable ones.
+ */
+typedef struct distanceTree32
+{
+  int numVertices;
+  int startVertex;
+  int32_t* distances;
+  int* predecessors;
+} DistanceTree32;
+
+typedef struct distanceTree64
+{
+  int numVertices;
+  int startVertex;
+  int64_t* distances;
+  int* predecessors;
+} DistanceTree64;
+
+typedef struct distanceTreeDouble
+{
+  int numVertices;
+  int startVertex;
+  double* distances;
+  int* predecessors;
+} DistanceTreeDouble;
+
+/*
+ * The cost of 'edge' in the unit of a search, e.g. travel time from its
+ * length and a speed kept in 'data'. Must be non-negative.
+ */
+typedef double (*EdgeCost)(Edge* edge, void* data);
+
+/*
+ * Run Dijkstra's algorithm on 'graph' from 'startVertex' with edge
+ * weights as costs, or for the double variant 'cost' if it is not NULL.
+ * Edge weights must be non-negative. In DistanceTree32 a path weighing
+ * DISTANCE32_INFINITY or more counts as unreachable; in DistanceTree64
+ * that cannot happen for graphs of fewer than 2^32 vertices.
+ * Return NULL on invalid arguments or allocation failure.
+ */
+DistanceTree32* getDistanceTree32(Graph* graph, int startVertex);
+DistanceTree64* getDistanceTree64(Graph* graph, int startVertex);
+DistanceTreeDouble* getDistanceTreeDouble(Graph* graph, int startVertex,
+                                          EdgeCost cost, void* data);
+
+void deleteDistanceTree32(DistanceTree32* tree);
+void deleteDistanceTree64(DistanceTree64* tree);
+void deleteDistanceTreeDouble(DistanceTreeDouble* tree);
+
+/*
+ * Returns an upper bound on the weight of any shortest path in 'graph':
+ * (numVertices - 1) times the largest edge weight. The int32_t variant
+ * is safe iff this is less than DISTANCE32_INFINITY.
+ */
+int64_t getMaxPathWeight(Graph* graph);
+
+#endif
@@ -0,0 +1,422 @@
+/*
+ * Parallel parsers for DIMACS, SNAP and CSV edge lists.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "edgefile.h"
+
+/*
+ * The lines of the file that start in [begin, end), parsed by one thread.
+ */
+typedef struct parseChunk
+{
+  const char* begin;
+  const char* end;
+  const char* fileStart;   // for the CSV header line
+  EdgeFormat format;
+  Edge* edges;             // in file order, vertex IDs from 0
+  long numEdges;
+  long capacity;
+  int maxVertex;           // largest vertex ID seen, -1 if none
+  int declaredVertices;    // from a DIMACS problem line, 0 if none
+  bool failed;             // malformed line or allocation failure
+} ParseChunk;
+
+/*************************************************************************
+ ** Line parsing
+ *************************************************************************/
+
+static const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    return p;
+}
+
+/*
+ * Returns true iff only blanks and a "\r" are left on the line.
+ */
+static bool atLineEnd(const char* p, const char* end) {
+    p = skipBlanks(p, end);
+    return p == end || (*p == '\r' && p + 1 == end);
+}
+
+/*
+ * Parses a decimal int at '*pos', without locale or errno handling, and
+ * advances '*pos' past it. Returns false if there is none or it does not
+ * fit in an int.
+ */
+static bool parseInt(const char** pos, const char* end, int* value) {
+    const char* p = *pos;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+    long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > (long long)INT_MAX + 1) {
+            return false;
+        }
+        p++;
+    }
+    result = negative ? -result : result;
+    if (result > INT_MAX) {
+        return false;
+    }
+    *value = (int)result;
+    *pos = p;
+    return true;
+}
+
+/*
+ * Moves '*pos' from the end of one field to the start of the next: past
+ * a comma for CSV, past at least one blank otherwise.
+ */
+static bool nextField(const char** pos, const char* end, EdgeFormat format) {
+    const char* p = skipBlanks(*pos, end);
+    if (format == EDGE_FORMAT_CSV) {
+        if (p == end || *p != ',') {
+            return false;
+        }
+        p = skipBlanks(p + 1, end);
+    } else if (p == *pos) {
+        return false;
+    }
+    *pos = p;
+    return true;
+}
+
+static bool pushEdge(ParseChunk* chunk, int u, int v, int weight) {
+    if (chunk->numEdges == chunk->capacity) {
+        long capacity = chunk->capacity > 0 ? 2 * chunk->capacity : 1024;
+        Edge* edges = (Edge*)realloc(chunk->edges, capacity * sizeof(Edge));
+        if (edges == NULL) {
+            return false;
+        }
+        chunk->edges = edges;
+        chunk->capacity = capacity;
+    }
+    Edge* edge = &chunk->edges[chunk->numEdges++];
+    edge->fromVertex = u;
+    edge->toVertex = v;
+    edge->weight = weight;
+    if (u > chunk->maxVertex) {
+        chunk->maxVertex = u;
+    }
+    if (v > chunk->maxVertex) {
+        chunk->maxVertex = v;
+    }
+    return true;
+}
+
+/*
+ * Parses the DIMACS problem line "p <type> <n> <m>" at 'p', just past
+ * the 'p'.
+ */
+static bool parseProblemLine(ParseChunk* chunk, const char* p, const char* end) {
+    if (!nextField(&p, end, EDGE_FORMAT_DIMACS)) {
+        return false;
+    }
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r') {
+        p++;
+    }
+    int n, m;
+    if (!nextField(&p, end, EDGE_FORMAT_DIMACS) || !parseInt(&p, end, &n) ||
+        !nextField(&p, end, EDGE_FORMAT_DIMACS) || !parseInt(&p, end, &m) ||
+        !atLineEnd(p, end) || n < 0 || m < 0) {
+        return false;
+    }
+    if (n > chunk->declaredVertices) {
+        chunk->declaredVertices = n;
+    }
+    return true;
+}
+
+/*
+ * Parses the line [line, end), without its "\n". Returns false if it is
+ * malformed or the edge cannot be stored.
+ */
+static bool parseLine(ParseChunk* chunk, const char* line, const char* end) {
+    const char* p = skipBlanks(line, end);
+    if (atLineEnd(p, end)) {
+        return true;
+    }
+    EdgeFormat format = chunk->format;
+    if (format == EDGE_FORMAT_DIMACS) {
+        if (*p == 'c') {
+            return true;
+        }
+        if (*p == 'p') {
+            return parseProblemLine(chunk, p + 1, end);
+        }
+        if (*p != 'a') {
+            return false;
+        }
+        p++;
+        if (!nextField(&p, end, format)) {
+            return false;
+        }
+    } else if (*p == '#' || (format == EDGE_FORMAT_SNAP && *p == '%')) {
+        return true;
+    } else if (format == EDGE_FORMAT_CSV && line == chunk->fileStart &&
+               *p != '-' && *p != '+' && (*p < '0' || *p > '9')) {
+        return true;  // header line
+    }
+
+    int u, v;
+    int weight = 1;
+    if (!parseInt(&p, end, &u) || !nextField(&p, end, format) || !parseInt(&p, end, &v)) {
+        return false;
+    }
+    if (format == EDGE_FORMAT_DIMACS || !atLineEnd(p, end)) {
+        if (!nextField(&p, end, format) || !parseInt(&p, end, &weight)) {
+            return false;
+        }
+    }
+    if (!atLineEnd(p, end)) {
+        return false;
+    }
+    if (format == EDGE_FORMAT_DIMACS) {
+        u--;
+        v--;
+    }
+    if (u < 0 || v < 0) {
+        return false;
+    }
+    return pushEdge(chunk, u, v, weight);
+}
+
+static void* parseWorker(void* arg) {
+    ParseChunk* chunk = (ParseChunk*)arg;
+    const char* line = chunk->begin;
+    while (line < chunk->end) {
+        const char* eol = (const char*)memchr(line, '\n', chunk->end - line);
+        if (eol == NULL) {
+            eol = chunk->end;
+        }
+        if (!parseLine(chunk, line, eol)) {
+            chunk->failed = true;
+            return NULL;
+        }
+        line = eol + 1;
+    }
+    return NULL;
+}
+
+/*************************************************************************
+ ** Splitting the file
+ *************************************************************************/
+
+static void freeChunks(ParseChunk* chunks, int numChunks) {
+    if (chunks != NULL) {
+        for (int t = 0; t < numChunks; t++) {
+            free(chunks[t].edges);
+        }
+        free(chunks);
+    }
+}
+
+/*
+ * Parses the file at 'path' into one ParseChunk per thread and stores the
+ * number of vertices and edges found. Returns NULL on failure.
+ */
+static ParseChunk* parseFile(const char* path, EdgeFormat format, int numThreads,
+                             int* numVertices, int* numEdges) {
+    if (path == NULL || numThreads <= 0) {
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)info.st_size;
+    void* base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    posix_madvise(base, length, POSIX_MADV_SEQUENTIAL);
+
+    ParseChunk* chunks = (ParseChunk*)calloc(numThreads, sizeof(ParseChunk));
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    bool* started = (bool*)calloc(numThreads, sizeof(bool));
+    if (chunks == NULL || threads == NULL || started == NULL) {
+        munmap(base, length);
+        free(chunks);
+        free(threads);
+        free(started);
+        return NULL;
+    }
+    const char* data = (const char*)base;
+    const char* dataEnd = data + length;
+    // every block starts at the beginning of a line
+    const char* begin = data;
+    for (int t = 0; t < numThreads; t++) {
+        const char* end = data + (size_t)((double)length * (t + 1) / numThreads);
+        if (t == numThreads - 1) {
+            end = dataEnd;
+        }
+        if (end < begin) {
+            end = begin;
+        }
+        while (end > data && end < dataEnd && end[-1] != '\n') {
+            end++;
+        }
+        chunks[t].begin = begin;
+        chunks[t].end = end;
+        chunks[t].fileStart = data;
+        chunks[t].format = format;
+        chunks[t].maxVertex = -1;
+        begin = end;
+    }
+    for (int t = 1; t < numThreads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, parseWorker, &chunks[t]) == 0;
+    }
+    // blocks whose thread could not be started are parsed here
+    for (int t = 0; t < numThreads; t++) {
+        if (!started[t]) {
+            parseWorker(&chunks[t]);
+        }
+    }
+    for (int t = 1; t < numThreads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    munmap(base, length);
+    free(threads);
+    free(started);
+
+    long totalEdges = 0;
+    int maxVertex = -1;
+    int declaredVertices = 0;
+    bool failed = false;
+    for (int t = 0; t < numThreads; t++) {
+        failed = failed || chunks[t].failed;
+        totalEdges += chunks[t].numEdges;
+        if (chunks[t].maxVertex > maxVertex) {
+            maxVertex = chunks[t].maxVertex;
+        }
+        if (chunks[t].declaredVertices > declaredVertices) {
+            declaredVertices = chunks[t].declaredVertices;
+        }
+    }
+    if (failed || totalEdges > INT_MAX || maxVertex == INT_MAX) {
+        freeChunks(chunks, numThreads);
+        return NULL;
+    }
+    *numVertices = maxVertex + 1 > declaredVertices ? maxVertex + 1 : declaredVertices;
+    *numEdges = (int)totalEdges;
+    if (*numVertices == 0) {
+        freeChunks(chunks, numThreads);
+        return NULL;
+    }
+    return chunks;
+}
+
+/*************************************************************************
+ ** Building graphs
+ *************************************************************************/
+
+CSRGraph* readCSRGraphEdges(const char* path, EdgeFormat format, int numThreads) {
+    int n, m;
+    ParseChunk* chunks = parseFile(path, format, numThreads, &n, &m);
+    if (chunks == NULL) {
+        return NULL;
+    }
+    CSRGraph* csr = (CSRGraph*)calloc(1, sizeof(CSRGraph));
+    int* next = (int*)malloc(n * sizeof(int));
+    if (csr != NULL) {
+        csr->numVertices = n;
+        csr->numEdges = m;
+        csr->offsets = (int*)calloc(n + 1, sizeof(int));
+        // +1 so that an edgeless graph still gets non-NULL arrays
+        csr->targets = (int*)malloc((m + 1) * sizeof(int));
+        csr->weights = (int*)malloc((m + 1) * sizeof(int));
+    }
+    if (csr == NULL || next == NULL || csr->offsets == NULL || csr->targets == NULL ||
+        csr->weights == NULL) {
+        deleteCSRGraph(csr);
+        free(next);
+        freeChunks(chunks, numThreads);
+        return NULL;
+    }
+    // counting sort by fromVertex straight from the blocks, which are in
+    // file order, so each vertex keeps the file order of its edges
+    for (int t = 0; t < numThreads; t++) {
+        for (long i = 0; i < chunks[t].numEdges; i++) {
+            csr->offsets[chunks[t].edges[i].fromVertex + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        csr->offsets[u + 1] += csr->offsets[u];
+        next[u] = csr->offsets[u];
+    }
+    for (int t = 0; t < numThreads; t++) {
+        for (long i = 0; i < chunks[t].numEdges; i++) {
+            Edge* edge = &chunks[t].edges[i];
+            csr->targets[next[edge->fromVertex]] = edge->toVertex;
+            csr->weights[next[edge->fromVertex]] = edge->weight;
+            next[edge->fromVertex]++;
+        }
+        // release each block as soon as it is copied
+        free(chunks[t].edges);
+        chunks[t].edges = NULL;
+    }
+    free(next);
+    freeChunks(chunks, numThreads);
+    return csr;
+}
+
+Graph* readGraphEdges(const char* path, EdgeFormat format, int numThreads) {
+    int n, m;
+    ParseChunk* chunks = parseFile(path, format, numThreads, &n, &m);
+    if (chunks == NULL) {
+        return NULL;
+    }
+    Graph* graph = newArenaGraph(n, 0);
+    if (graph == NULL) {
+        freeChunks(chunks, numThreads);
+        return NULL;
+    }
+    Arena* previous = setCurrentArena(graph->arena);
+    // prepending in reverse file order leaves each adjList in file order
+    for (int t = numThreads - 1; t >= 0; t--) {
+        for (long i = chunks[t].numEdges - 1; i >= 0; i--) {
+            Edge* parsed = &chunks[t].edges[i];
+            Vertex* vertex = graph->vertices[parsed->fromVertex];
+            Edge* edge = newEdge(parsed->fromVertex, parsed->toVertex, parsed->weight);
+            EdgeList* node = edge != NULL ? newEdgeList(edge, vertex->adjList) : NULL;
+            if (node == NULL) {
+                setCurrentArena(previous);
+                deleteGraph(graph);
+                freeChunks(chunks, numThreads);
+                return NULL;
+            }
+            vertex->adjList = node;
+            graph->numEdges++;
+        }
+    }
+    setCurrentArena(previous);
+    freeChunks(chunks, numThreads);
+    return graph;
+}
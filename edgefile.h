@@ -0,0 +1,49 @@
+/*
+ * Parsers for text edge lists.
+ *
+ * Supported formats, one edge or directive per line:
+ *
+ *   EDGE_FORMAT_DIMACS  9th DIMACS challenge .gr: "c ..." comments, a
+ *                       "p sp <n> <m>" problem line and "a <u> <v> <w>"
+ *                       arcs with vertex IDs starting at 1
+ *   EDGE_FORMAT_SNAP    SNAP edge lists: "# ..." comments and
+ *                       "<u> <v> [<w>]" separated by blanks or tabs
+ *   EDGE_FORMAT_CSV     "<u>,<v>[,<w>]", optionally after a header line
+ *                       at the top of the file
+ *
+ * SNAP and CSV vertex IDs start at 0, and a missing weight is 1. Blank
+ * lines and "\r\n" line ends are accepted in every format. The file is
+ * mapped into memory and split into one block of lines per thread.
+ */
+
+#ifndef EDGEFILE_H
+#define EDGEFILE_H
+
+#include "graph.h"
+#include "csr.h"
+
+typedef enum edgeFormat
+{
+  EDGE_FORMAT_DIMACS,
+  EDGE_FORMAT_SNAP,
+  EDGE_FORMAT_CSV
+} EdgeFormat;
+
+/*
+ * Reads the edge list at 'path' in 'format' using 'numThreads' threads
+ * and returns it as a CSRGraph. Edges of each vertex keep their order in
+ * the file. The graph has as many vertices as the DIMACS problem line
+ * declares, or as the largest vertex ID needs, whichever is more.
+ * Returns NULL if the file cannot be read, a line is malformed, there
+ * are no vertices, or on allocation failure.
+ */
+CSRGraph* readCSRGraphEdges(const char* path, EdgeFormat format, int numThreads);
+
+/*
+ * Same as readCSRGraphEdges, but returns a Graph whose Edge and EdgeList
+ * nodes are allocated from its own arena (see newArenaGraph). Each
+ * adjList is in file order.
+ */
+Graph* readGraphEdges(const char* path, EdgeFormat format, int numThreads);
+
+#endif
@@ -67,7 +67,7 @@ void printGraph(Graph* graph)
 
 Edge* newEdge(int fromVertex, int toVertex, int weight)
 {
-    Edge* e = (Edge*)calloc(1, sizeof(Edge));
+    Edge* e = (Edge*)arenaCalloc(1, sizeof(Edge));
     if (e == NULL) {
         return NULL;
     }
@@ -79,7 +79,7 @@ Edge* newEdge(int fromVertex, int toVertex, int weight)
 
 EdgeList* newEdgeList(Edge* edge, EdgeList* next)
 {
-    EdgeList* el = (EdgeList*)calloc(1, sizeof(EdgeList));
+    EdgeList* el = (EdgeList*)arenaCalloc(1, sizeof(EdgeList));
     if (el == NULL) {
         return NULL;
     }
@@ -90,7 +90,7 @@ EdgeList* newEdgeList(Edge* edge, EdgeList* next)
 
 Vertex* newVertex(int id, void* value, EdgeList* adjList)
 {
-    Vertex* v = (Vertex*)calloc(1, sizeof(Vertex));
+    Vertex* v = (Vertex*)arenaCalloc(1, sizeof(Vertex));
     if (v == NULL) {
         return NULL;
     }
@@ -113,6 +113,9 @@ Graph* newGraph(int numVertices) {
         free(g);
         return NULL;
     }
+    // a graph without an arena owns heap vertices, whatever the caller's
+    // current arena is
+    Arena* previous = setCurrentArena(NULL);
     for (int i = 0; i < numVertices; i++) {
         g->vertices[i] = newVertex(i, NULL, NULL);
         if (g->vertices[i] == NULL) {
@@ -120,11 +123,44 @@ Graph* newGraph(int numVertices) {
             for (int j = 0; j < i; j++) {
                 free(g->vertices[j]);
             }
+            setCurrentArena(previous);
             free(g->vertices);
             free(g);
             return NULL;
         }
     }
+    setCurrentArena(previous);
+    return g;
+}
+Graph* newArenaGraph(int numVertices, size_t chunkSize) {
+    if (numVertices <= 0) {
+        return NULL;
+    }
+    Graph* g = (Graph*)calloc(1, sizeof(Graph));
+    if (g == NULL) {
+        return NULL;
+    }
+    g->numVertices = numVertices;
+    g->arena = newArena(chunkSize);
+    g->vertices = (Vertex**)calloc(numVertices, sizeof(Vertex*));
+    if (g->arena == NULL || g->vertices == NULL) {
+        deleteArena(g->arena);
+        free(g->vertices);
+        free(g);
+        return NULL;
+    }
+    Arena* previous = setCurrentArena(g->arena);
+    for (int i = 0; i < numVertices; i++) {
+        g->vertices[i] = newVertex(i, NULL, NULL);
+        if (g->vertices[i] == NULL) {
+            setCurrentArena(previous);
+            deleteArena(g->arena);
+            free(g->vertices);
+            free(g);
+            return NULL;
+        }
+    }
+    setCurrentArena(previous);
     return g;
 }
 void deleteEdgeList(EdgeList* head)
@@ -147,6 +183,13 @@ void deleteVertex(Vertex* vertex)
 }
 void deleteGraph(Graph* graph) {
     if (!graph) return;
+    if (graph->arena) {
+        // every Vertex, EdgeList and Edge lives in the arena
+        deleteArena(graph->arena);
+        free(graph->vertices);
+        free(graph);
+        return;
+    }
     if (graph->vertices) {
         for (int i = 0; i < graph->numVertices; i++) {
             if (graph->vertices[i]) {
@@ -158,3 +201,114 @@ void deleteGraph(Graph* graph) {
     free(graph);
 }
 
+
+/*********************************************************************
+ ** Updates
+ *********************************************************************/
+
+/*
+ * Returns true iff 'id' is a vertex of 'graph'.
+ */
+static bool isValidVertex(Graph* graph, int id) {
+    return graph != NULL && id >= 0 && id < graph->numVertices;
+}
+
+bool insertEdge(Graph* graph, int fromVertex, int toVertex, int weight) {
+    return insertCostEdge(graph, fromVertex, toVertex, weight, NULL);
+}
+
+bool insertCostEdge(Graph* graph, int fromVertex, int toVertex, int weight,
+                    const int* costs) {
+    if (!isValidVertex(graph, fromVertex) || !isValidVertex(graph, toVertex)) {
+        return false;
+    }
+    // allocate from the graph's own arena, or from calloc if it has none,
+    // whatever the caller's current arena is
+    Arena* previous = setCurrentArena(graph->arena);
+    Vertex* vertex = graph->vertices[fromVertex];
+    Edge* edge;
+    if (graph->numCosts > 0) {
+        CostEdge* costEdge = (CostEdge*)arenaCalloc(1, sizeof(CostEdge) +
+                                                       graph->numCosts * sizeof(int));
+        edge = (costEdge == NULL) ? NULL : &costEdge->edge;
+        if (edge != NULL) {
+            edge->fromVertex = fromVertex;
+            edge->toVertex = toVertex;
+            edge->weight = weight;
+            for (int k = 0; costs != NULL && k < graph->numCosts; k++) {
+                costEdge->costs[k] = costs[k];
+            }
+        }
+    } else {
+        edge = newEdge(fromVertex, toVertex, weight);
+    }
+    EdgeList* node = (edge == NULL) ? NULL : newEdgeList(edge, vertex->adjList);
+    if (node == NULL) {
+        arenaFree(edge);
+        setCurrentArena(previous);
+        return false;
+    }
+    setCurrentArena(previous);
+    vertex->adjList = node;
+    graph->numEdges++;
+    graph->version++;
+    return true;
+}
+
+bool setNumCosts(Graph* graph, int numCosts) {
+    if (graph == NULL || numCosts < 0) {
+        return false;
+    }
+    // edges added without insertEdge are not always counted in numEdges
+    for (int i = 0; i < graph->numVertices; i++) {
+        if (graph->vertices[i]->adjList != NULL) {
+            return false;
+        }
+    }
+    graph->numCosts = numCosts;
+    return true;
+}
+
+int* getEdgeCosts(Graph* graph, Edge* edge) {
+    if (graph == NULL || edge == NULL || graph->numCosts == 0) {
+        return NULL;
+    }
+    return ((CostEdge*)edge)->costs;
+}
+
+bool deleteEdge(Graph* graph, int fromVertex, int toVertex) {
+    if (!isValidVertex(graph, fromVertex)) {
+        return false;
+    }
+    EdgeList** link = &graph->vertices[fromVertex]->adjList;
+    while (*link != NULL && (*link)->edge->toVertex != toVertex) {
+        link = &(*link)->next;
+    }
+    if (*link == NULL) {
+        return false;
+    }
+    EdgeList* node = *link;
+    *link = node->next;
+    // an arena-owned graph gets the memory back when it is deleted
+    if (graph->arena == NULL) {
+        free(node->edge);
+        free(node);
+    }
+    graph->numEdges--;
+    graph->version++;
+    return true;
+}
+
+bool setEdgeWeight(Graph* graph, int fromVertex, int toVertex, int weight) {
+    if (!isValidVertex(graph, fromVertex)) {
+        return false;
+    }
+    for (EdgeList* adj = graph->vertices[fromVertex]->adjList; adj != NULL; adj = adj->next) {
+        if (adj->edge->toVertex == toVertex) {
+            adj->edge->weight = weight;
+            graph->version++;
+            return true;
+        }
+    }
+    return false;
+}
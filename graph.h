@@ -0,0 +1,161 @@
+/*
+ * Our graph implementation.
+ *
+ * Author: Akshay Arun Bapat
+ * Based on implementation from A. Tafliovich
+ */
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+/*
+ * A directed edge 'fromVertex' -> 'toVertex' of weight 'weight'.
+ */
+typedef struct edge
+{
+  int fromVertex;
+  int toVertex;
+  int weight;
+} Edge;
+
+/*
+ * An Edge followed by further cost attributes, e.g. a toll or the
+ * clearance of a road, as many as the 'numCosts' of its graph. A
+ * CostEdge* is an Edge* to everything that only reads 'weight'; every
+ * edge of a graph with numCosts > 0 is a CostEdge.
+ */
+typedef struct costEdge
+{
+  Edge edge;
+  int costs[];
+} CostEdge;
+
+/*
+ * A node of a linked list of edges.
+ */
+typedef struct edgeList
+{
+  Edge* edge;
+  struct edgeList* next;
+} EdgeList;
+
+/*
+ * A vertex with an arbitrary payload 'value' and its outgoing edges.
+ */
+typedef struct vertex
+{
+  int id;             // 0, 1, ..., numVertices-1
+  void* value;        // payload, freed with the vertex
+  EdgeList* adjList;  // outgoing edges
+} Vertex;
+
+typedef struct graph
+{
+  int numVertices;
+  int numEdges;
+  Vertex** vertices;  // vertices[id] is the vertex with ID id
+  Arena* arena;       // if not NULL, owns every Vertex, EdgeList and Edge
+  unsigned long version;  // bumped by every edge update, so results
+                          //   computed on an older version can be told
+                          //   apart; code that edits adjLists directly
+                          //   must bump it too
+  int numCosts;       // cost attributes of every edge besides its weight
+                      //   (see CostEdge), 0 unless set by setNumCosts
+} Graph;
+
+/*********************************************************************
+ ** Helper functions provided in the starter code
+ *********************************************************************/
+void printEdge(Edge* edge);
+void printEdgeList(EdgeList* head);
+void printVertex(Vertex* vertex);
+void printGraph(Graph* graph);
+
+/*********************************************************************
+ ** Required functions
+ *********************************************************************/
+
+/*
+ * newEdge, newEdgeList and newVertex allocate from the current arena
+ * (see setCurrentArena) if one is set, and from calloc otherwise.
+ * deleteEdgeList and deleteVertex free() every node they reach, so they
+ * must only be given calloc'd lists and vertices: nodes that came from
+ * an arena are released with it, by deleteGraph for an arena graph, and
+ * must not be passed to them. Graphs and paths returned by the functions of this library
+ * never come from the current arena, so their owner does not depend on
+ * it: newGraph's vertices and the nodes of paths are calloc'd, and an
+ * arena graph's nodes belong to graph->arena.
+ */
+Edge* newEdge(int fromVertex, int toVertex, int weight);
+EdgeList* newEdgeList(Edge* edge, EdgeList* next);
+Vertex* newVertex(int id, void* value, EdgeList* adjList);
+Graph* newGraph(int numVertices);
+void deleteEdgeList(EdgeList* head);
+void deleteVertex(Vertex* vertex);
+void deleteGraph(Graph* graph);
+
+/*
+ * Same as newGraph, but the returned graph owns an arena of chunks of
+ * 'chunkSize' bytes (a default size if 0) that its vertices are
+ * allocated from. Make it the current arena (setCurrentArena) while
+ * adding edges with newEdge / newEdgeList so they come from it too.
+ * deleteGraph then frees the arena in one go: payloads in Vertex.value
+ * must come from the arena as well, or be freed by the caller.
+ */
+Graph* newArenaGraph(int numVertices, size_t chunkSize);
+
+/*
+ * Edge updates. insertEdge prepends 'fromVertex' -> 'toVertex' to the
+ * adjList of 'fromVertex'. deleteEdge and setEdgeWeight act on the first
+ * 'fromVertex' -> 'toVertex' edge in that adjList. All three return
+ * false on invalid vertices, if there is no such edge, or on allocation
+ * failure, and keep graph->numEdges up to date. Each successful update
+ * increments graph->version. Nodes come from and go back to graph->arena
+ * if the graph has one.
+ */
+bool insertEdge(Graph* graph, int fromVertex, int toVertex, int weight);
+bool deleteEdge(Graph* graph, int fromVertex, int toVertex);
+bool setEdgeWeight(Graph* graph, int fromVertex, int toVertex, int weight);
+
+/*
+ * Cost attributes. setNumCosts gives every edge of 'graph' 'numCosts'
+ * attributes; it returns false unless 'graph' has no edges yet.
+ * insertCostEdge is insertEdge with the attributes in 'costs', which
+ * holds graph->numCosts values or is NULL for all zeros; insertEdge
+ * gives the edges of such a graph all zeros too. getEdgeCosts returns
+ * the attributes of an edge of 'graph', or NULL if it has none. Copies
+ * of a graph made with newEdge, such as newReverseGraph's, do not keep
+ * the attributes.
+ */
+bool setNumCosts(Graph* graph, int numCosts);
+bool insertCostEdge(Graph* graph, int fromVertex, int toVertex, int weight,
+                    const int* costs);
+int* getEdgeCosts(Graph* graph, Edge* edge);
+
+/*********************************************************************
+ ** Graph algorithms
+ *********************************************************************/
+
+/*
+ * Returns 'distance' + 'weight', or INT_MAX if that does not fit in an
+ * int. INT_MAX is "unreached", so a relaxation through an unreached
+ * vertex, or one that would overflow, never lowers a distance. Every
+ * int search relaxes with it, on linked and CSR graphs alike, so that
+ * they agree on paths too heavy for an int.
+ */
+static inline int addDistance(int distance, int weight) {
+    long long sum = (long long)distance + weight;
+    return (distance == INT_MAX || sum >= INT_MAX) ? INT_MAX : (int)sum;
+}
+
+Edge* getMSTprim(Graph* graph, int startVertex);
+Edge* getDistanceTreeDijkstra(Graph* graph, int startVertex);
+EdgeList** getShortestPaths(Edge* distTree, int numVertices, int startVertex);
+
+#endif
@@ -6,9 +6,17 @@
  */
 
 #include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
 #include "graph.h"
 #include "minheap.h"
+#include "pq.h"
+#include "graph_algos.h"
+#include "search_queue.h"
+#include "stats.h"
 #include <stdio.h>
 
 /*
@@ -18,12 +26,14 @@ typedef struct records
 {
   int numVertices;    // total number of vertices in the graph
                       // vertex IDs are 0, 1, ..., numVertices-1
-  MinHeap* heap;      // priority queue
+  PriorityQueue* heap; // priority queue
   bool* finished;     // finished[id] is true iff vertex id is finished
   int* distances;                     //   i.e. no longer in the PQ
   int* predecessors;  // predecessors[id] is the predecessor of vertex id
   Edge* tree;         // keeps edges for the resulting tree
   int numTreeEdges;   // current number of edges in mst
+  int* touched;       // vertices reached by the current run, only kept
+  int numTouched;     //   by reusable records (see newReusableRecords)
 } Records;
 
 /*************************************************************************
@@ -36,29 +46,53 @@ typedef struct records
  * Precondition: 'startVertex' is valid in 'graph'
  */
 MinHeap* initHeap(Graph* graph, int startVertex){
-    MinHeap* heap = newHeap(graph->numVertices);
+    int* priorities = (int*)malloc(graph->numVertices * sizeof(int));
+    if (priorities == NULL) {
+        return NULL;
+    }
     for (int i = 0; i <= graph->numVertices-1; i++) {
-        int priority;
-        if (i == startVertex) {
-            priority = 0;  // Priority 0 for the start vertex
-        } else {
-            priority = INT_MAX;  // INT_MAX for all other vertices
-        }
-        insert(heap, priority, i); // perform insert to assign priority
+        // Priority 0 for the start vertex, INT_MAX for all other vertices
+        priorities[i] = (i == startVertex) ? 0 : INT_MAX;
     }
+    // one bottom-up build instead of an insert per vertex
+    MinHeap* heap = newHeapFromPriorities(priorities, graph->numVertices);
+    free(priorities);
     return heap;
 }
+/*
+ * Creates and returns the priority queue of kind 'kind' to be used by
+ * Prim's and Dijkstra's algorithms on Graph 'graph' starting from vertex
+ * with ID 'startVertex'. The binary heap is populated by initHeap as
+ * before; every other backend starts out holding 'startVertex' only.
+ * Precondition: 'startVertex' is valid in 'graph'
+ */
+PriorityQueue* initPQ(Graph* graph, int startVertex, PQKind kind){
+    if (kind == PQ_BINARY_HEAP) {
+        MinHeap* heap = initHeap(graph, startVertex);
+        PriorityQueue* pq = newPQFromHeap(heap);
+        if (pq == NULL) {
+            deleteHeap(heap);
+        }
+        return pq;
+    }
+    PriorityQueue* pq = newPQ(kind, graph->numVertices);
+    if (pq != NULL && !pqPush(pq, 0, startVertex)) {
+        deletePQ(pq);
+        return NULL;
+    }
+    return pq;
+}
 /*
  * Creates, populates, and returns all records needed to run Prim's and
  * Dijkstra's algorithms on Graph 'graph' starting from vertex with ID
- * 'startVertex'.
+ * 'startVertex', using a priority queue of kind 'kind'.
  * Precondition: 'startVertex' is valid in 'graph'
  */
-Records* initRecords(Graph* graph, int startVertex){
+Records* initRecordsPQ(Graph* graph, int startVertex, PQKind kind){
     Records* records = (Records*)calloc(1, sizeof(Records));
     if (records == NULL) return NULL;
     records->numVertices = graph->numVertices;
-    records->heap = initHeap(graph, startVertex);
+    records->heap = initPQ(graph, startVertex, kind);
     if (records->heap == NULL) {
         free(records);
         return NULL;
@@ -77,8 +111,7 @@ Records* initRecords(Graph* graph, int startVertex){
         // initialize distance
     }
     if (records->finished == NULL || records->predecessors == NULL) {
-        free(records->heap->indexMap);
-        free(records->heap);
+        deletePQ(records->heap);
         free(records->finished);
         free(records->predecessors);
         free(records);
@@ -86,6 +119,12 @@ Records* initRecords(Graph* graph, int startVertex){
     }
     return records;
 }
+/*
+ * Same as initRecordsPQ with the binary heap.
+ */
+Records* initRecords(Graph* graph, int startVertex){
+    return initRecordsPQ(graph, startVertex, PQ_BINARY_HEAP);
+}
 /*
  * Returns true iff 'heap' is NULL or is empty.
  */
@@ -103,55 +142,46 @@ void addTreeEdge(Records* records, int ind, int fromVertex, int toVertex,
 }
 
 /*
- * Creates and returns a path from 'vertex' to 'startVertex' from edges
- * in the distance tree 'distTree'.
+ * Frees a partly built path whose nodes came from arenaCalloc under the
+ * current arena, which must still be the one they came from.
  */
+static void discardPath(EdgeList* path) {
+    while (path != NULL) {
+        EdgeList* next = path->next;
+        arenaFree(path->edge);
+        arenaFree(path);
+        path = next;
+    }
+}
 
-EdgeList* makePath(Edge* distTree, int vertex, int startVertex) {
+/*
+ * Same as makePath, with the nodes allocated from the current arena,
+ * which the caller pins to their owner.
+ */
+static EdgeList* makePathInCurrentArena(Edge* distTree, int vertex, int startVertex) {
     EdgeList* path = NULL;
     int currentVertex = vertex;
     // Traverse vertex to startVertex, makePath in reverse order
     while (currentVertex != startVertex) {
         int pred = distTree[currentVertex].fromVertex;
         if (pred == -1) {
-            while (path != NULL) {
-                EdgeList* temp = path;
-                path = path->next;
-                free(temp->edge); // free edge
-                free(temp);
-            }
+            discardPath(path);
             return NULL;
         }
         // find direct weight using accumulative weights from dijkstra
         int directWeight = distTree[currentVertex].weight - (pred != startVertex ? distTree[pred].weight : 0);
-        // create edge
-        Edge* newEdge = (Edge*)malloc(sizeof(Edge));
-        if (newEdge == NULL) {
-            while (path != NULL) {
-                EdgeList* temp = path;
-                path = path->next;
-                free(temp->edge); // free edge
-                free(temp);
-            }
+        Edge* edge = newEdge(currentVertex, pred, directWeight);
+        if (edge == NULL) {
+            discardPath(path);
             return NULL;
         }
-        newEdge->fromVertex = currentVertex;
-        newEdge->toVertex = pred;
-        newEdge->weight = directWeight;
-        EdgeList* newNode = (EdgeList*)malloc(sizeof(EdgeList));
+        // prepend edge to front of linked list
+        EdgeList* newNode = newEdgeList(edge, path);
         if (newNode == NULL) {
-            free(newEdge);
-            while (path != NULL) {
-                EdgeList* temp = path;
-                path = path->next;
-                free(temp->edge);//free edge
-                free(temp);
-            }
+            arenaFree(edge);
+            discardPath(path);
             return NULL;
         }
-        // prepend edge to front of linked list
-        newNode->edge = newEdge;
-        newNode->next = path;
         path = newNode;
         currentVertex = pred;
     }
@@ -166,6 +196,17 @@ EdgeList* makePath(Edge* distTree, int vertex, int startVertex) {
     }
     return reversedPath;
 }
+
+/*
+ * Creates and returns a path from 'vertex' to 'startVertex' from edges
+ * in the distance tree 'distTree'.
+ */
+EdgeList* makePath(Edge* distTree, int vertex, int startVertex) {
+    Arena* previous = setCurrentArena(NULL);
+    EdgeList* path = makePathInCurrentArena(distTree, vertex, startVertex);
+    setCurrentArena(previous);
+    return path;
+}
 bool isInHeap(MinHeap* heap, int vertexId) {
     if (heap == NULL || vertexId < 0 || vertexId >= heap->capacity) {
         return false;  // check error
@@ -185,7 +226,7 @@ void printRecords(Records* records)
     printf("Reporting on algorithm's records on %d vertices...\n", numVertices);
 
     printf("The PQ is:\n");
-    printHeap(records->heap);
+    printPQ(records->heap);
 
     printf("The finished array is:\n");
     for (int i = 0; i < numVertices; i++)
@@ -203,40 +244,136 @@ void printRecords(Records* records)
 // use this helper function to reduce redundancy in code
 void freeRecords(Records* records) {
     if (!records) return;
-    deleteHeap(records->heap);
+    deletePQ(records->heap);
     free(records->finished);
     free(records->predecessors);
     free(records->distances);
     free(records->tree);
+    free(records->touched);
     free(records);
 }
 
+/*
+ * Creates and returns records that can be used for any number of runs
+ * on 'graph': every distance starts at INT_MAX, every predecessor at -1,
+ * and resetRecords puts back only the entries a run touched.
+ */
+static Records* newReusableRecords(Graph* graph) {
+    int n = graph->numVertices;
+    Records* records = (Records*)calloc(1, sizeof(Records));
+    if (records == NULL) return NULL;
+    records->numVertices = n;
+    records->heap = newPQ(PQ_DARY_HEAP, n);
+    records->finished = (bool*)calloc(n, sizeof(bool));
+    records->distances = (int*)malloc(n * sizeof(int));
+    records->predecessors = (int*)malloc(n * sizeof(int));
+    records->touched = (int*)malloc(n * sizeof(int));
+    if (records->heap == NULL || records->finished == NULL || records->distances == NULL ||
+        records->predecessors == NULL || records->touched == NULL) {
+        freeRecords(records);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        records->distances[i] = INT_MAX;
+        records->predecessors[i] = -1;
+    }
+    return records;
+}
+
+/*
+ * Undoes the run recorded in 'records' in time proportional to the
+ * number of vertices it touched.
+ */
+static void resetRecords(Records* records) {
+    for (int i = 0; i < records->numTouched; i++) {
+        int v = records->touched[i];
+        records->distances[v] = INT_MAX;
+        records->predecessors[v] = -1;
+        records->finished[v] = false;
+    }
+    records->numTouched = 0;
+    pqClear(records->heap);
+}
+
+/*
+ * Runs Dijkstra's algorithm from 'startVertex' on freshly reset reusable
+ * 'records', leaving the results in records->distances and
+ * records->predecessors.
+ */
+static void runReusableDijkstra(Graph* graph, Records* records, int startVertex) {
+    records->distances[startVertex] = 0;
+    records->touched[records->numTouched++] = startVertex;
+    pqPush(records->heap, 0, startVertex);
+    STATS_TIMER(loopStart);
+    while (!pqIsEmpty(records->heap)) {
+        int u = pqExtractMin(records->heap).id;
+        records->finished[u] = true;
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            int v = adjList->edge->toVertex;
+            int distance = addDistance(records->distances[u], adjList->edge->weight);
+            STATS_COUNT(edgesScanned, 1);
+            if (!records->finished[v] && distance < records->distances[v]) {
+                STATS_COUNT(relaxations, 1);
+                if (records->distances[v] == INT_MAX) {
+                    records->touched[records->numTouched++] = v;
+                }
+                records->distances[v] = distance;
+                records->predecessors[v] = u;
+                pqPush(records->heap, distance, v);
+            }
+        }
+    }
+    STATS_ADD_TIME(loopSeconds, loopStart);
+}
+
 Edge* getMSTprim(Graph* graph, int startVertex) {
+    return getMSTprimPQ(graph, startVertex, PQ_BINARY_HEAP);
+}
+
+Edge* getMSTprimPQ(Graph* graph, int startVertex, PQKind kind) {
     if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {
         return NULL;
     }
-    Records *records = initRecords(graph, startVertex);
+    // Prim's keys are not monotone, which the radix heap requires
+    if (kind == PQ_RADIX_HEAP) {
+        kind = PQ_DARY_HEAP;
+    }
+    STATS_TIMER(initStart);
+    Records *records = initRecordsPQ(graph, startVertex, kind);
     if (records == NULL) {
         return NULL;
     }
-    while (!isEmpty(records->heap)) {
-        HeapNode minNode = extractMin(records->heap);
+    STATS_ADD_TIME(initSeconds, initStart);
+    STATS_TIMER(loopStart);
+    bool ok = true;
+    while (ok && !pqIsEmpty(records->heap)) {
+        HeapNode minNode = pqExtractMin(records->heap);
         int u = minNode.id;
+        if (records->finished[u]) {
+            continue; // stale entry left by a lazy backend
+        }
         records->finished[u] = true; // mark vertex finished
         if (records->predecessors[u] != -1 && u != startVertex) {
             addTreeEdge(records, records->numTreeEdges, u, records->predecessors[u], minNode.priority);
             records->numTreeEdges++; // number of tree edges ++
         }
-        for (EdgeList *adj_list = graph->vertices[u]->adjList; adj_list != NULL; adj_list = adj_list->next) {
+        for (EdgeList *adj_list = graph->vertices[u]->adjList; ok && adj_list != NULL; adj_list = adj_list->next) {
             Edge *edge = adj_list->edge;
             int v = edge->toVertex;
+            STATS_COUNT(edgesScanned, 1);
             if (!records->finished[v] && edge->weight < records->distances[v]) {
-                decreasePriority(records->heap, v, edge->weight);
+                STATS_COUNT(relaxations, 1);
+                ok = pqPush(records->heap, edge->weight, v);
                 records->distances[v] = edge->weight;  // update min edge weight
                 records->predecessors[v] = u;  // Update predecessor
             }
         }
     }
+    STATS_ADD_TIME(loopSeconds, loopStart);
+    if (!ok) {
+        freeRecords(records);
+        return NULL;
+    }
     Edge* tree = records->tree;
     records->tree = NULL;
     freeRecords(records);
@@ -244,10 +381,15 @@ Edge* getMSTprim(Graph* graph, int startVertex) {
 }
 
 Edge* getDistanceTreeDijkstra(Graph* graph, int startVertex) {
+    return getDistanceTreeDijkstraPQ(graph, startVertex, PQ_BINARY_HEAP);
+}
+
+Edge* getDistanceTreeDijkstraPQ(Graph* graph, int startVertex, PQKind kind) {
     if (startVertex < 0 || startVertex >= graph->numVertices) {
         return NULL;
     }
-    Records* records = initRecords(graph, startVertex);
+    STATS_TIMER(initStart);
+    Records* records = initRecordsPQ(graph, startVertex, kind);
     if (records == NULL) {
         return NULL;
     }
@@ -258,17 +400,29 @@ Edge* getDistanceTreeDijkstra(Graph* graph, int startVertex) {
         freeRecords(records);
         return NULL;
     }
-    while (!isEmpty(records->heap)) {
-        HeapNode minNode = extractMin(records->heap);
+    STATS_ADD_TIME(initSeconds, initStart);
+    STATS_TIMER(loopStart);
+    bool ok = true;
+    while (ok && !pqIsEmpty(records->heap)) {
+        HeapNode minNode = pqExtractMin(records->heap);
         int u = minNode.id;
+        if (u == -1) {
+            ok = false;  // the radix heap ran out of memory
+            break;
+        }
+        if (records->finished[u]) {
+            continue; // stale entry left by a lazy backend
+        }
         records->finished[u] = true;
-        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; ok && adjList != NULL; adjList = adjList->next) {
             Edge* edge = adjList->edge;
             int v = edge->toVertex;
             int weight = edge->weight;
-            int distance = records->distances[u] + weight;
+            int distance = addDistance(records->distances[u], weight);
+            STATS_COUNT(edgesScanned, 1);
             if (!records->finished[v] && distance < records->distances[v]) {
-                decreasePriority(records->heap, v, distance);
+                STATS_COUNT(relaxations, 1);
+                ok = pqPush(records->heap, distance, v);
                 records->distances[v] = distance;
                 records->predecessors[v] = u;
                 distTree[v].fromVertex = u;
@@ -277,6 +431,12 @@ Edge* getDistanceTreeDijkstra(Graph* graph, int startVertex) {
             }
         }
     }
+    STATS_ADD_TIME(loopSeconds, loopStart);
+    if (!ok) {
+        free(distTree);
+        freeRecords(records);
+        return NULL;
+    }
     // to match output given sample_output.txt
     distTree[startVertex].fromVertex = startVertex;
     distTree[startVertex].toVertex = startVertex;
@@ -284,37 +444,1156 @@ Edge* getDistanceTreeDijkstra(Graph* graph, int startVertex) {
     freeRecords(records);
     return distTree;
 }
-EdgeList** getShortestPaths(Edge* distTree, int numVertices, int startVertex) {
+/*
+ * getShortestPaths with the array and every path allocated from 'arena',
+ * or from calloc if 'arena' is NULL, whatever the caller's current arena
+ * is.
+ */
+static EdgeList** makeShortestPaths(Edge* distTree, int numVertices, int startVertex,
+                                    Arena* arena) {
     if (!distTree) return NULL;
+    STATS_TIMER(pathStart);
     distTree[startVertex].fromVertex = -1; // No predecessor
     distTree[startVertex].toVertex = startVertex;
     distTree[startVertex].weight = 0;
-    EdgeList** paths = (EdgeList**)calloc(numVertices, sizeof(EdgeList*));
+    Arena* previous = setCurrentArena(arena);
+    EdgeList** paths = (EdgeList**)arenaCalloc(numVertices, sizeof(EdgeList*));
     if (!paths) {
+        setCurrentArena(previous);
         return NULL;
     }
     for (int i = 0; i < numVertices; i++) {
         if (i == startVertex) {
             paths[i] = NULL;
         } else if (distTree[i].fromVertex != -1) {
-            paths[i] = makePath(distTree, i, startVertex);
+            paths[i] = makePathInCurrentArena(distTree, i, startVertex);
             if (!paths[i] && distTree[i].fromVertex != -1) {
                 for (int j = 0; j < i; j++) {
-                    EdgeList* current = paths[j];
-                    while (current) {
-                        EdgeList* next = current->next;
-                        free(current->edge);
-                        free(current);
-                        current = next;
-                    }
+                    discardPath(paths[j]);
                 }
-                free(paths);
+                arenaFree(paths);
+                setCurrentArena(previous);
                 return NULL;
             }
         }
     }
+    setCurrentArena(previous);
+    STATS_ADD_TIME(pathSeconds, pathStart);
     return paths;
 }
+
+EdgeList** getShortestPaths(Edge* distTree, int numVertices, int startVertex) {
+    return makeShortestPaths(distTree, numVertices, startVertex, NULL);
+}
+
+EdgeList** getShortestPathsArena(Edge* distTree, int numVertices, int startVertex,
+                                 Arena* arena) {
+    if (arena == NULL) {
+        return NULL;
+    }
+    return makeShortestPaths(distTree, numVertices, startVertex, arena);
+}
+EdgeList* makePathFromPredecessors(int* predecessors, int* predWeights, int vertex,
+                                   int startVertex) {
+    EdgeList* path = NULL;
+    EdgeList* tail = NULL;
+    // paths are calloc'd, whatever the caller's current arena is
+    Arena* previous = setCurrentArena(NULL);
+    for (int v = vertex; v != startVertex; v = predecessors[v]) {
+        Edge* edge = newEdge(v, predecessors[v], predWeights[v]);
+        EdgeList* node = (edge == NULL) ? NULL : newEdgeList(edge, NULL);
+        if (node == NULL) {
+            arenaFree(edge);
+            deleteEdgeList(path);
+            setCurrentArena(previous);
+            return NULL;
+        }
+        if (tail == NULL) {
+            path = node;
+        } else {
+            tail->next = node;
+        }
+        tail = node;
+    }
+    setCurrentArena(previous);
+    return path;
+}
+
+/*
+ * One direction of a point-to-point search. Entries of distances,
+ * predecessors and predWeights are only meaningful where reached is set,
+ * so nothing has to be initialised per vertex.
+ */
+typedef struct searchSide
+{
+  Graph* graph;         // graph whose adjLists this side scans
+  bool* reached;        // reached[id] is true iff id has a distance
+  bool* finished;       // finished[id] is true iff id is settled
+  int* distances;       // distances[id] is the best distance found so far
+  int* predecessors;    // predecessors[id] is the previous vertex on it
+  int* predWeights;     // predWeights[id] is the weight of that edge
+  PriorityQueue* heap;  // lazy PQ of reached, unfinished vertices
+} SearchSide;
+
+static void freeSearchSide(SearchSide* side) {
+    deletePQ(side->heap);
+    free(side->reached);
+    free(side->finished);
+    free(side->distances);
+    free(side->predecessors);
+    free(side->predWeights);
+}
+
+/*
+ * Allocates 'side' for a search over 'graph' from 'startVertex'.
+ * Returns false on allocation failure, leaving nothing allocated.
+ */
+static bool initSearchSide(SearchSide* side, Graph* graph, int startVertex) {
+    int n = graph->numVertices;
+    side->graph = graph;
+    // calloc'd pages are only touched once a vertex is reached
+    side->reached = (bool*)calloc(n, sizeof(bool));
+    side->finished = (bool*)calloc(n, sizeof(bool));
+    side->distances = (int*)malloc(n * sizeof(int));
+    side->predecessors = (int*)malloc(n * sizeof(int));
+    side->predWeights = (int*)malloc(n * sizeof(int));
+    side->heap = newPQ(PQ_LAZY_HEAP, n);
+    if (side->reached == NULL || side->finished == NULL || side->distances == NULL ||
+        side->predecessors == NULL || side->predWeights == NULL || side->heap == NULL) {
+        freeSearchSide(side);
+        return false;
+    }
+    side->reached[startVertex] = true;
+    side->distances[startVertex] = 0;
+    side->predecessors[startVertex] = -1;
+    if (!pqPush(side->heap, 0, startVertex)) {
+        freeSearchSide(side);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Extracts vertices from 'side' until an unfinished one comes up, marks
+ * it finished and returns it. Returns -1 if the heap runs out.
+ */
+static int settleNext(SearchSide* side) {
+    while (!pqIsEmpty(side->heap)) {
+        int u = pqExtractMin(side->heap).id;
+        if (!side->finished[u]) {
+            side->finished[u] = true;
+            return u;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Relaxes edge u -> v of weight 'weight' on 'side'. Returns false if the
+ * heap could not grow, in which case the search must stop: 'v' would
+ * never be settled.
+ */
+static bool relaxSearchEdge(SearchSide* side, int u, int v, int weight) {
+    int distance = addDistance(side->distances[u], weight);
+    STATS_COUNT(edgesScanned, 1);
+    if (!side->finished[v] && (!side->reached[v] || distance < side->distances[v])) {
+        STATS_COUNT(relaxations, 1);
+        side->reached[v] = true;
+        side->distances[v] = distance;
+        side->predecessors[v] = u;
+        side->predWeights[v] = weight;
+        return pqPush(side->heap, distance, v);
+    }
+    return true;
+}
+
+EdgeList* getShortestPath(Graph* graph, int startVertex, int targetVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    SearchSide forward;
+    if (!initSearchSide(&forward, graph, startVertex)) {
+        return NULL;
+    }
+    EdgeList* path = NULL;
+    bool ok = true;
+    int u;
+    while (ok && (u = settleNext(&forward)) != -1) {
+        if (u == targetVertex) {
+            path = makePathFromPredecessors(forward.predecessors, forward.predWeights,
+                                            targetVertex, startVertex);
+            break;
+        }
+        for (EdgeList* adjList = graph->vertices[u]->adjList; ok && adjList != NULL; adjList = adjList->next) {
+            ok = relaxSearchEdge(&forward, u, adjList->edge->toVertex, adjList->edge->weight);
+        }
+    }
+    freeSearchSide(&forward);
+    return path;
+}
+
+Graph* newReverseGraph(Graph* graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    Graph* reverse = newGraph(graph->numVertices);
+    if (reverse == NULL) {
+        return NULL;
+    }
+    // 'reverse' has no arena, so its edges are calloc'd too
+    Arena* previous = setCurrentArena(NULL);
+    for (int u = 0; u < graph->numVertices; u++) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            Edge* edge = adjList->edge;
+            Edge* reversed = newEdge(edge->toVertex, edge->fromVertex, edge->weight);
+            EdgeList* node = (reversed == NULL) ? NULL :
+                newEdgeList(reversed, reverse->vertices[edge->toVertex]->adjList);
+            if (node == NULL) {
+                arenaFree(reversed);
+                setCurrentArena(previous);
+                deleteGraph(reverse);
+                return NULL;
+            }
+            reverse->vertices[edge->toVertex]->adjList = node;
+            reverse->numEdges++;
+        }
+    }
+    setCurrentArena(previous);
+    return reverse;
+}
+
+/*
+ * Scans the out-edges of 'u', just settled on 'side', and lowers 'best'
+ * and 'meeting' whenever an edge reaches a vertex that 'other' has
+ * reached. Returns false if 'side' could not queue a vertex.
+ */
+static bool scanBidirectional(SearchSide* side, SearchSide* other, int u,
+                              long* best, int* meeting) {
+    if (other->reached[u] && (long)side->distances[u] + other->distances[u] < *best) {
+        *best = (long)side->distances[u] + other->distances[u];
+        *meeting = u;
+    }
+    for (EdgeList* adjList = side->graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+        int v = adjList->edge->toVertex;
+        if (!relaxSearchEdge(side, u, v, adjList->edge->weight)) {
+            return false;
+        }
+        if (other->reached[v] &&
+            (long)side->distances[v] + other->distances[v] < *best) {
+            *best = (long)side->distances[v] + other->distances[v];
+            *meeting = v;
+        }
+    }
+    return true;
+}
+
+EdgeList* getShortestPathBidirectional(Graph* graph, Graph* reverse,
+                                       int startVertex, int targetVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    if (reverse == NULL) {
+        reverse = graph;  // undirected: every edge has its twin in graph
+    }
+    SearchSide forward, backward;
+    if (!initSearchSide(&forward, graph, startVertex)) {
+        return NULL;
+    }
+    if (!initSearchSide(&backward, reverse, targetVertex)) {
+        freeSearchSide(&forward);
+        return NULL;
+    }
+    long best = LONG_MAX;
+    int meeting = -1;
+    bool ok = true;
+    while (ok && !pqIsEmpty(forward.heap) && !pqIsEmpty(backward.heap)) {
+        int forwardMin = pqGetMin(forward.heap).priority;
+        int backwardMin = pqGetMin(backward.heap).priority;
+        // no path through an unsettled vertex can beat 'best' any more
+        if ((long)forwardMin + backwardMin >= best) {
+            break;
+        }
+        if (forwardMin <= backwardMin) {
+            int u = settleNext(&forward);
+            if (u != -1) {
+                ok = scanBidirectional(&forward, &backward, u, &best, &meeting);
+            }
+        } else {
+            int u = settleNext(&backward);
+            if (u != -1) {
+                ok = scanBidirectional(&backward, &forward, u, &best, &meeting);
+            }
+        }
+    }
+    EdgeList* path = NULL;
+    if (ok && meeting != -1) {
+        // meeting -> startVertex along the forward tree, then prepend the
+        // backward tree edges from meeting out to targetVertex
+        path = makePathFromPredecessors(forward.predecessors, forward.predWeights,
+                                        meeting, startVertex);
+        bool failed = (path == NULL && meeting != startVertex);
+        Arena* previous = setCurrentArena(NULL);
+        for (int v = meeting; !failed && v != targetVertex; v = backward.predecessors[v]) {
+            int next = backward.predecessors[v];
+            Edge* edge = newEdge(next, v, backward.predWeights[v]);
+            EdgeList* node = (edge == NULL) ? NULL : newEdgeList(edge, path);
+            if (node == NULL) {
+                arenaFree(edge);
+                failed = true;
+            } else {
+                path = node;
+            }
+        }
+        setCurrentArena(previous);
+        if (failed) {
+            deleteEdgeList(path);
+            path = NULL;
+        }
+    }
+    freeSearchSide(&forward);
+    freeSearchSide(&backward);
+    return path;
+}
+
+EdgeList* getShortestPathAStar(Graph* graph, int startVertex, int targetVertex,
+                               Heuristic heuristic, void* data, int* numSettled) {
+    if (numSettled != NULL) {
+        *numSettled = 0;
+    }
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    SearchSide forward;
+    if (!initSearchSide(&forward, graph, startVertex)) {
+        return NULL;
+    }
+    EdgeList* path = NULL;
+    int settled = 0;
+    bool ok = true;
+    int u;
+    while (ok && (u = settleNext(&forward)) != -1) {
+        settled++;
+        if (u == targetVertex) {
+            path = makePathFromPredecessors(forward.predecessors, forward.predWeights,
+                                            targetVertex, startVertex);
+            break;
+        }
+        for (EdgeList* adjList = graph->vertices[u]->adjList; ok && adjList != NULL; adjList = adjList->next) {
+            int v = adjList->edge->toVertex;
+            int distance = addDistance(forward.distances[u], adjList->edge->weight);
+            STATS_COUNT(edgesScanned, 1);
+            if (!forward.finished[v] && (!forward.reached[v] || distance < forward.distances[v])) {
+                STATS_COUNT(relaxations, 1);
+                forward.reached[v] = true;
+                forward.distances[v] = distance;
+                forward.predecessors[v] = u;
+                forward.predWeights[v] = adjList->edge->weight;
+                int estimate = heuristic == NULL ? 0 : heuristic(graph, v, targetVertex, data);
+                // a key that does not fit in an int stays last, not negative
+                ok = pqPush(forward.heap, addDistance(distance, estimate), v);
+            }
+        }
+    }
+    if (numSettled != NULL) {
+        *numSettled = settled;
+    }
+    freeSearchSide(&forward);
+    return path;
+}
+
+/*************************************************************************
+ ** Heuristics for getShortestPathAStar
+ *************************************************************************/
+
+bool setVertexCoordinates(Graph* graph, int id, double x, double y) {
+    if (graph == NULL || id < 0 || id >= graph->numVertices) {
+        return false;
+    }
+    // payloads of arena graphs must live in the arena too
+    Coordinates* coords = (graph->arena != NULL)
+        ? (Coordinates*)arenaAlloc(graph->arena, sizeof(Coordinates))
+        : (Coordinates*)malloc(sizeof(Coordinates));
+    if (coords == NULL) {
+        return false;
+    }
+    coords->x = x;
+    coords->y = y;
+    if (graph->arena == NULL) {
+        free(graph->vertices[id]->value);
+    }
+    graph->vertices[id]->value = coords;
+    return true;
+}
+
+double euclideanDistance(Coordinates* a, Coordinates* b) {
+    double dx = a->x - b->x;
+    double dy = a->y - b->y;
+    return sqrt(dx * dx + dy * dy);
+}
+
+double haversineDistance(Coordinates* a, Coordinates* b) {
+    const double earthRadius = 6371000.0;  // meters
+    const double toRadians = 3.14159265358979323846 / 180.0;
+    double lat1 = a->y * toRadians;
+    double lat2 = b->y * toRadians;
+    double sinLat = sin((lat2 - lat1) / 2);
+    double sinLon = sin((b->x - a->x) * toRadians / 2);
+    double h = sinLat * sinLat + cos(lat1) * cos(lat2) * sinLon * sinLon;
+    return 2 * earthRadius * asin(sqrt(h < 1.0 ? h : 1.0));
+}
+
+double getAdmissibleScale(Graph* graph, Metric metric) {
+    if (graph == NULL || metric == NULL) {
+        return 0.0;
+    }
+    double scale = HUGE_VAL;
+    for (int u = 0; u < graph->numVertices; u++) {
+        Coordinates* from = (Coordinates*)graph->vertices[u]->value;
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            Coordinates* to = (Coordinates*)graph->vertices[adjList->edge->toVertex]->value;
+            if (from == NULL || to == NULL) {
+                return 0.0;  // cannot bound an edge with a missing endpoint
+            }
+            double length = metric(from, to);
+            if (length > 0 && adjList->edge->weight / length < scale) {
+                scale = adjList->edge->weight / length;
+            }
+        }
+    }
+    return scale == HUGE_VAL ? 0.0 : scale;
+}
+
+/*
+ * Returns floor(scale * metric(vertex, targetVertex)), or 0 if either
+ * vertex has no coordinates.
+ */
+static int metricHeuristic(Graph* graph, int vertex, int targetVertex,
+                           double scale, Metric metric) {
+    Coordinates* from = (Coordinates*)graph->vertices[vertex]->value;
+    Coordinates* to = (Coordinates*)graph->vertices[targetVertex]->value;
+    if (from == NULL || to == NULL) {
+        return 0;
+    }
+    double estimate = scale * metric(from, to);
+    return estimate >= INT_MAX ? INT_MAX - 1 : (int)estimate;
+}
+
+int euclideanHeuristic(Graph* graph, int vertex, int targetVertex, void* scale) {
+    return metricHeuristic(graph, vertex, targetVertex, *(double*)scale, euclideanDistance);
+}
+
+int haversineHeuristic(Graph* graph, int vertex, int targetVertex, void* scale) {
+    return metricHeuristic(graph, vertex, targetVertex, *(double*)scale, haversineDistance);
+}
+
+/*
+ * Runs Dijkstra from 'startVertex' in 'graph' to completion and writes
+ * every distance into 'distances', INT_MAX for unreachable vertices.
+ * Returns false on allocation failure.
+ */
+static bool fillDistances(Graph* graph, int startVertex, int* distances) {
+    SearchSide side;
+    if (!initSearchSide(&side, graph, startVertex)) {
+        return false;
+    }
+    bool ok = true;
+    int u;
+    while (ok && (u = settleNext(&side)) != -1) {
+        for (EdgeList* adjList = graph->vertices[u]->adjList; ok && adjList != NULL; adjList = adjList->next) {
+            ok = relaxSearchEdge(&side, u, adjList->edge->toVertex, adjList->edge->weight);
+        }
+    }
+    if (!ok) {
+        freeSearchSide(&side);
+        return false;
+    }
+    for (int v = 0; v < graph->numVertices; v++) {
+        distances[v] = side.reached[v] ? side.distances[v] : INT_MAX;
+    }
+    freeSearchSide(&side);
+    return true;
+}
+
+Landmarks* newLandmarks(Graph* graph, Graph* reverse, int numLandmarks) {
+    if (graph == NULL || numLandmarks <= 0) {
+        return NULL;
+    }
+    if (reverse == NULL) {
+        reverse = graph;
+    }
+    int n = graph->numVertices;
+    if (numLandmarks > n) {
+        numLandmarks = n;
+    }
+    Landmarks* landmarks = (Landmarks*)calloc(1, sizeof(Landmarks));
+    if (landmarks == NULL) {
+        return NULL;
+    }
+    landmarks->numLandmarks = numLandmarks;
+    landmarks->numVertices = n;
+    landmarks->ids = (int*)malloc(numLandmarks * sizeof(int));
+    landmarks->fromDistances = (int*)malloc((size_t)numLandmarks * n * sizeof(int));
+    landmarks->toDistances = (int*)malloc((size_t)numLandmarks * n * sizeof(int));
+    // closest[v] is the distance from v's nearest landmark so far
+    long* closest = (long*)malloc(n * sizeof(long));
+    if (landmarks->ids == NULL || landmarks->fromDistances == NULL ||
+        landmarks->toDistances == NULL || closest == NULL) {
+        free(closest);
+        deleteLandmarks(landmarks);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        closest[v] = LONG_MAX;
+    }
+    // farthest selection: start anywhere, then keep picking the reached
+    // vertex farthest from every landmark chosen so far
+    int next = 0;
+    for (int l = 0; l < numLandmarks; l++) {
+        landmarks->ids[l] = next;
+        int* from = landmarks->fromDistances + (size_t)l * n;
+        int* to = landmarks->toDistances + (size_t)l * n;
+        if (!fillDistances(graph, next, from) || !fillDistances(reverse, next, to)) {
+            free(closest);
+            deleteLandmarks(landmarks);
+            return NULL;
+        }
+        long farthest = -1;
+        for (int v = 0; v < n; v++) {
+            if (from[v] != INT_MAX && from[v] < closest[v]) {
+                closest[v] = from[v];
+            }
+            if (closest[v] != LONG_MAX && closest[v] > farthest) {
+                farthest = closest[v];
+                next = v;
+            }
+        }
+    }
+    free(closest);
+    return landmarks;
+}
+
+void deleteLandmarks(Landmarks* landmarks) {
+    if (!landmarks) return;
+    free(landmarks->ids);
+    free(landmarks->fromDistances);
+    free(landmarks->toDistances);
+    free(landmarks);
+}
+
+int altHeuristic(Graph* graph, int vertex, int targetVertex, void* data) {
+    (void)graph;
+    Landmarks* landmarks = (Landmarks*)data;
+    int n = landmarks->numVertices;
+    int best = 0;
+    for (int l = 0; l < landmarks->numLandmarks; l++) {
+        int* from = landmarks->fromDistances + (size_t)l * n;
+        int* to = landmarks->toDistances + (size_t)l * n;
+        // d(L, t) <= d(L, v) + d(v, t) and d(v, L) <= d(v, t) + d(t, L)
+        if (from[targetVertex] != INT_MAX && from[vertex] != INT_MAX &&
+            from[targetVertex] - from[vertex] > best) {
+            best = from[targetVertex] - from[vertex];
+        }
+        if (to[vertex] != INT_MAX && to[targetVertex] != INT_MAX &&
+            to[vertex] - to[targetVertex] > best) {
+            best = to[vertex] - to[targetVertex];
+        }
+    }
+    return best;
+}
+
+/*
+ * Work shared by the threads of getDistanceMatrixParallel.
+ */
+typedef struct matrixJob
+{
+  Graph* graph;
+  int* sources;
+  int numSources;
+  int* matrix;
+  atomic_int nextSource;  // next index into sources to hand out
+} MatrixJob;
+
+static void* matrixWorker(void* arg) {
+    MatrixJob* job = (MatrixJob*)arg;
+    int n = job->graph->numVertices;
+    Records* records = newReusableRecords(job->graph);
+    if (records == NULL) {
+        return NULL;  // leave the sources to the other threads
+    }
+    int i;
+    while ((i = atomic_fetch_add(&job->nextSource, 1)) < job->numSources) {
+        int* row = job->matrix + (size_t)i * n;
+        int source = job->sources[i];
+        if (source < 0 || source >= n) {
+            for (int v = 0; v < n; v++) {
+                row[v] = INT_MAX;
+            }
+            continue;
+        }
+        runReusableDijkstra(job->graph, records, source);
+        memcpy(row, records->distances, n * sizeof(int));
+        resetRecords(records);
+    }
+    freeRecords(records);
+    return NULL;
+}
+
+bool getDistanceMatrixParallel(Graph* graph, int* sources, int numSources,
+                               int* matrix, int numThreads) {
+    if (graph == NULL || sources == NULL || matrix == NULL || numSources < 0 ||
+        numThreads <= 0) {
+        return false;
+    }
+    if (numThreads > numSources) {
+        numThreads = numSources > 0 ? numSources : 1;
+    }
+    MatrixJob job;
+    job.graph = graph;
+    job.sources = sources;
+    job.numSources = numSources;
+    job.matrix = matrix;
+    atomic_init(&job.nextSource, 0);
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (threads == NULL) {
+        return false;
+    }
+    int numStarted = 0;
+    for (int t = 0; t < numThreads - 1; t++) {
+        if (pthread_create(&threads[numStarted], NULL, matrixWorker, &job) == 0) {
+            numStarted++;
+        }
+    }
+    // the calling thread works too, and picks up whatever is left if
+    // some threads could not be started
+    matrixWorker(&job);
+    for (int t = 0; t < numStarted; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+    // any thread that got its records drained every source, so rows are
+    // only left unwritten if every thread failed to allocate
+    return atomic_load(&job.nextSource) >= numSources;
+}
+
+DEFINE_SEARCH_QUEUE_DARY(TableQueue, int64_t)
+
+/*
+ * The search of getDistanceTable: Dijkstra with int64_t distances, so
+ * that table entries of INT_MAX or more are exact, which like reusable
+ * records puts back only what the previous run touched.
+ */
+typedef struct tableSearch
+{
+  int64_t* distances;   // DISTANCE_TABLE_UNREACHABLE where not reached
+  bool* finished;
+  int* touched;
+  int numTouched;
+  TableQueue queue;
+} TableSearch;
+
+static void freeTableSearch(TableSearch* search) {
+    free(search->distances);
+    free(search->finished);
+    free(search->touched);
+    TableQueueFree(&search->queue);
+}
+
+static bool initTableSearch(TableSearch* search, int n) {
+    bool queued = TableQueueInit(&search->queue, n);
+    search->distances = (int64_t*)malloc(n * sizeof(int64_t));
+    search->finished = (bool*)calloc(n, sizeof(bool));
+    search->touched = (int*)malloc(n * sizeof(int));
+    search->numTouched = 0;
+    if (!queued || search->distances == NULL || search->finished == NULL ||
+        search->touched == NULL) {
+        if (queued) {
+            TableQueueFree(&search->queue);
+        }
+        free(search->distances);
+        free(search->finished);
+        free(search->touched);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        search->distances[i] = DISTANCE_TABLE_UNREACHABLE;
+    }
+    return true;
+}
+
+/*
+ * Undoes the previous run, then runs Dijkstra's algorithm from
+ * 'startVertex' until all 'numTargets' vertices marked in 'isTarget' are
+ * finished.
+ */
+static void runTableSearch(Graph* graph, TableSearch* search, int startVertex,
+                           bool* isTarget, int numTargets) {
+    for (int i = 0; i < search->numTouched; i++) {
+        int v = search->touched[i];
+        search->distances[v] = DISTANCE_TABLE_UNREACHABLE;
+        search->finished[v] = false;
+    }
+    search->numTouched = 0;
+    TableQueueClear(&search->queue);
+    search->distances[startVertex] = 0;
+    search->touched[search->numTouched++] = startVertex;
+    TableQueuePush(&search->queue, 0, startVertex);
+    STATS_TIMER(loopStart);
+    while (!TableQueueIsEmpty(&search->queue)) {
+        int64_t key;
+        int u = TableQueuePop(&search->queue, &key);
+        search->finished[u] = true;
+        if (isTarget[u] && --numTargets == 0) {
+            break;
+        }
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            int v = adjList->edge->toVertex;
+            int64_t distance = SEARCH_ADD_INT64(search->distances[u],
+                                                (int64_t)adjList->edge->weight);
+            STATS_COUNT(edgesScanned, 1);
+            if (!search->finished[v] && distance < search->distances[v]) {
+                STATS_COUNT(relaxations, 1);
+                if (search->distances[v] == DISTANCE_TABLE_UNREACHABLE) {
+                    search->touched[search->numTouched++] = v;
+                }
+                search->distances[v] = distance;
+                TableQueuePush(&search->queue, distance, v);
+            }
+        }
+    }
+    STATS_ADD_TIME(loopSeconds, loopStart);
+}
+
+bool getDistanceTable(Graph* graph, int* sources, int numSources, int* targets,
+                      int numTargets, int64_t* table) {
+    if (graph == NULL || sources == NULL || targets == NULL || table == NULL ||
+        numSources < 0 || numTargets < 0) {
+        return false;
+    }
+    int n = graph->numVertices;
+    TableSearch search;
+    if (!initTableSearch(&search, n)) {
+        return false;
+    }
+    bool* isTarget = (bool*)calloc(n, sizeof(bool));
+    if (isTarget == NULL) {
+        freeTableSearch(&search);
+        return false;
+    }
+    int numDistinct = 0;
+    for (int j = 0; j < numTargets; j++) {
+        if (targets[j] >= 0 && targets[j] < n && !isTarget[targets[j]]) {
+            isTarget[targets[j]] = true;
+            numDistinct++;
+        }
+    }
+    for (int i = 0; i < numSources; i++) {
+        int64_t* row = table + (size_t)i * numTargets;
+        int source = sources[i];
+        if (source < 0 || source >= n) {
+            for (int j = 0; j < numTargets; j++) {
+                row[j] = DISTANCE_TABLE_UNREACHABLE;
+            }
+            continue;
+        }
+        if (numDistinct > 0) {
+            runTableSearch(graph, &search, source, isTarget, numDistinct);
+        }
+        for (int j = 0; j < numTargets; j++) {
+            int v = targets[j];
+            row[j] = (v >= 0 && v < n && search.finished[v]) ?
+                     search.distances[v] : DISTANCE_TABLE_UNREACHABLE;
+        }
+    }
+    freeTableSearch(&search);
+    free(isTarget);
+    return true;
+}
+
+/*************************************************************************
+ ** Minimum spanning forests
+ *************************************************************************/
+
+void deleteSpanningForest(SpanningForest* forest) {
+    if (!forest) return;
+    free(forest->treeEdges);
+    free(forest->componentOf);
+    free(forest->componentStarts);
+    free(forest->componentWeights);
+    free(forest);
+}
+
+SpanningForest* getMinimumSpanningForest(Graph* graph) {
+    if (graph == NULL) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    SpanningForest* forest = (SpanningForest*)calloc(1, sizeof(SpanningForest));
+    if (forest == NULL) {
+        return NULL;
+    }
+    forest->numVertices = n;
+    forest->treeEdges = (Edge*)malloc(n * sizeof(Edge));
+    forest->componentOf = (int*)malloc(n * sizeof(int));
+    forest->componentStarts = (int*)malloc((n + 1) * sizeof(int));
+    forest->componentWeights = (long long*)malloc(n * sizeof(long long));
+    int* keys = (int*)malloc(n * sizeof(int));
+    int* predecessors = (int*)malloc(n * sizeof(int));
+    // vertices only enter the queue once an edge reaches them
+    PriorityQueue* heap = newPQ(PQ_DARY_HEAP, n);
+    if (forest->treeEdges == NULL || forest->componentOf == NULL ||
+        forest->componentStarts == NULL || forest->componentWeights == NULL ||
+        keys == NULL || predecessors == NULL || heap == NULL) {
+        deleteSpanningForest(forest);
+        free(keys);
+        free(predecessors);
+        deletePQ(heap);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        forest->componentOf[v] = -1;  // not finished yet
+        keys[v] = INT_MAX;
+    }
+    for (int root = 0; root < n; root++) {
+        if (forest->componentOf[root] != -1) {
+            continue;
+        }
+        // Prim's algorithm from the first vertex no earlier tree reached
+        int c = forest->numComponents++;
+        long long weight = 0;
+        forest->componentStarts[c] = forest->numTreeEdges;
+        keys[root] = 0;
+        predecessors[root] = -1;
+        pqPush(heap, 0, root);
+        while (!pqIsEmpty(heap)) {
+            int u = pqExtractMin(heap).id;
+            forest->componentOf[u] = c;
+            if (predecessors[u] != -1) {
+                Edge* edge = &forest->treeEdges[forest->numTreeEdges++];
+                edge->fromVertex = u;
+                edge->toVertex = predecessors[u];
+                edge->weight = keys[u];
+                weight += keys[u];
+            }
+            for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+                int v = adjList->edge->toVertex;
+                STATS_COUNT(edgesScanned, 1);
+                if (forest->componentOf[v] == -1 && adjList->edge->weight < keys[v]) {
+                    STATS_COUNT(relaxations, 1);
+                    keys[v] = adjList->edge->weight;
+                    predecessors[v] = u;
+                    pqPush(heap, keys[v], v);
+                }
+            }
+        }
+        forest->componentWeights[c] = weight;
+    }
+    forest->componentStarts[forest->numComponents] = forest->numTreeEdges;
+    free(keys);
+    free(predecessors);
+    deletePQ(heap);
+    return forest;
+}
+
+/*************************************************************************
+ ** Compact shortest path trees
+ *************************************************************************/
+
+void deleteShortestPathTree(ShortestPathTree* tree) {
+    if (!tree) return;
+    free(tree->distances);
+    free(tree->predecessors);
+    free(tree->predWeights);
+    free(tree);
+}
+
+ShortestPathTree* getShortestPathTree(Graph* graph, int startVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    ShortestPathTree* tree = (ShortestPathTree*)calloc(1, sizeof(ShortestPathTree));
+    if (tree == NULL) {
+        return NULL;
+    }
+    tree->numVertices = n;
+    tree->startVertex = startVertex;
+    tree->distances = (int*)malloc(n * sizeof(int));
+    tree->predecessors = (int*)malloc(n * sizeof(int));
+    tree->predWeights = (int*)calloc(n, sizeof(int));
+    bool* finished = (bool*)calloc(n, sizeof(bool));
+    PriorityQueue* heap = newPQ(PQ_DARY_HEAP, n);
+    if (tree->distances == NULL || tree->predecessors == NULL ||
+        tree->predWeights == NULL || finished == NULL || heap == NULL) {
+        deleteShortestPathTree(tree);
+        free(finished);
+        deletePQ(heap);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        tree->distances[i] = INT_MAX;
+        tree->predecessors[i] = -1;
+    }
+    tree->distances[startVertex] = 0;
+    pqPush(heap, 0, startVertex);
+    STATS_TIMER(loopStart);
+    while (!pqIsEmpty(heap)) {
+        int u = pqExtractMin(heap).id;
+        finished[u] = true;
+        for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+            int v = adjList->edge->toVertex;
+            int distance = addDistance(tree->distances[u], adjList->edge->weight);
+            STATS_COUNT(edgesScanned, 1);
+            if (!finished[v] && distance < tree->distances[v]) {
+                STATS_COUNT(relaxations, 1);
+                tree->distances[v] = distance;
+                tree->predecessors[v] = u;
+                tree->predWeights[v] = adjList->edge->weight;
+                pqPush(heap, distance, v);
+            }
+        }
+    }
+    STATS_ADD_TIME(loopSeconds, loopStart);
+    free(finished);
+    deletePQ(heap);
+    return tree;
+}
+
+/*
+ * Returns true iff 'vertex' is a valid vertex of 'tree' with a path from
+ * the start vertex.
+ */
+static bool isReachedInTree(ShortestPathTree* tree, int vertex) {
+    return tree != NULL && vertex >= 0 && vertex < tree->numVertices &&
+           tree->distances[vertex] != INT_MAX;
+}
+
+int getTreePathLength(ShortestPathTree* tree, int vertex) {
+    if (!isReachedInTree(tree, vertex)) {
+        return -1;
+    }
+    int length = 0;
+    for (int v = vertex; v != tree->startVertex; v = tree->predecessors[v]) {
+        length++;
+    }
+    return length;
+}
+
+int fillTreePath(ShortestPathTree* tree, int vertex, Edge* buffer, int capacity) {
+    if (!isReachedInTree(tree, vertex)) {
+        return -1;
+    }
+    int length = 0;
+    for (int v = vertex; v != tree->startVertex; v = tree->predecessors[v]) {
+        if (length < capacity) {
+            buffer[length].fromVertex = v;
+            buffer[length].toVertex = tree->predecessors[v];
+            buffer[length].weight = tree->predWeights[v];
+        }
+        length++;
+    }
+    return length;
+}
+
+void initPathIterator(PathIterator* iterator, ShortestPathTree* tree, int vertex) {
+    iterator->tree = tree;
+    // an unreachable vertex gives an empty walk
+    iterator->vertex = isReachedInTree(tree, vertex) ? vertex : -1;
+}
+
+bool nextPathEdge(PathIterator* iterator, Edge* edge) {
+    ShortestPathTree* tree = iterator->tree;
+    int v = iterator->vertex;
+    if (v == -1 || v == tree->startVertex) {
+        return false;
+    }
+    edge->fromVertex = v;
+    edge->toVertex = tree->predecessors[v];
+    edge->weight = tree->predWeights[v];
+    iterator->vertex = tree->predecessors[v];
+    return true;
+}
+
+EdgeList* getTreePath(ShortestPathTree* tree, int vertex) {
+    if (!isReachedInTree(tree, vertex)) {
+        return NULL;
+    }
+    return makePathFromPredecessors(tree->predecessors, tree->predWeights, vertex,
+                                    tree->startVertex);
+}
+
+/*************************************************************************
+ ** Incremental repair
+ *************************************************************************/
+
+/*
+ * Returns the smallest weight of an edge 'u' -> 'v' in 'graph', or
+ * INT_MAX if there is none.
+ */
+static int minEdgeWeight(Graph* graph, int u, int v) {
+    int weight = INT_MAX;
+    for (EdgeList* adjList = graph->vertices[u]->adjList; adjList != NULL; adjList = adjList->next) {
+        if (adjList->edge->toVertex == v && adjList->edge->weight < weight) {
+            weight = adjList->edge->weight;
+        }
+    }
+    return weight;
+}
+
+/*
+ * Sets the distance, predecessor and direct weight of 'v' in 'tree' and
+ * counts 'v' as touched the first time.
+ */
+static void setTreeEntry(ShortestPathTree* tree, bool* touched, int* numTouched,
+                         int v, int distance, int predecessor, int weight) {
+    tree->distances[v] = distance;
+    tree->predecessors[v] = predecessor;
+    tree->predWeights[v] = weight;
+    if (!touched[v]) {
+        touched[v] = true;
+        (*numTouched)++;
+    }
+}
+
+/*
+ * Collects into 'list' every vertex of 'tree' below one of the 'numRoots'
+ * vertices already in 'list', marking them in 'affected', and returns
+ * how many there are. Returns -1 on allocation failure.
+ */
+static int collectSubtrees(ShortestPathTree* tree, int* list, int numRoots, bool* affected) {
+    int n = tree->numVertices;
+    int* firstChild = (int*)malloc(n * sizeof(int));
+    int* nextSibling = (int*)malloc(n * sizeof(int));
+    if (firstChild == NULL || nextSibling == NULL) {
+        free(firstChild);
+        free(nextSibling);
+        return -1;
+    }
+    for (int v = 0; v < n; v++) {
+        firstChild[v] = -1;
+    }
+    for (int v = 0; v < n; v++) {
+        int parent = tree->predecessors[v];
+        if (parent != -1) {
+            nextSibling[v] = firstChild[parent];
+            firstChild[parent] = v;
+        }
+    }
+    int size = numRoots;
+    for (int i = 0; i < size; i++) {
+        for (int child = firstChild[list[i]]; child != -1; child = nextSibling[child]) {
+            if (!affected[child]) {
+                affected[child] = true;
+                list[size++] = child;
+            }
+        }
+    }
+    free(firstChild);
+    free(nextSibling);
+    return size;
+}
+
+int repairShortestPathTree(Graph* graph, Graph* reverse, ShortestPathTree* tree,
+                           Edge* changes, int numChanges) {
+    if (graph == NULL || tree == NULL || tree->numVertices != graph->numVertices ||
+        numChanges < 0 || (changes == NULL && numChanges > 0)) {
+        return -1;
+    }
+    int n = graph->numVertices;
+    Graph* in = (reverse != NULL) ? reverse : graph;
+    bool* affected = (bool*)calloc(n, sizeof(bool));
+    bool* touched = (bool*)calloc(n, sizeof(bool));
+    int* list = (int*)malloc(n * sizeof(int));
+    PriorityQueue* heap = newPQ(PQ_LAZY_HEAP, n);
+    if (affected == NULL || touched == NULL || list == NULL || heap == NULL) {
+        free(affected);
+        free(touched);
+        free(list);
+        deletePQ(heap);
+        return -1;
+    }
+    int numTouched = 0;
+    bool ok = true;
+
+    // a tree edge that got heavier or went away invalidates the subtree
+    // below it; every other distance is still an upper bound
+    int numAffected = 0;
+    for (int c = 0; c < numChanges; c++) {
+        int u = changes[c].fromVertex;
+        int v = changes[c].toVertex;
+        if (u < 0 || u >= n || v < 0 || v >= n || affected[v]) {
+            continue;
+        }
+        if (tree->predecessors[v] == u && minEdgeWeight(graph, u, v) > tree->predWeights[v]) {
+            affected[v] = true;
+            list[numAffected++] = v;
+        }
+    }
+    if (numAffected > 0) {
+        numAffected = collectSubtrees(tree, list, numAffected, affected);
+        ok = numAffected >= 0;
+    }
+    for (int i = 0; ok && i < numAffected; i++) {
+        setTreeEntry(tree, touched, &numTouched, list[i], INT_MAX, -1, 0);
+    }
+    // each invalidated vertex starts from its best unaffected in-neighbour
+    for (int i = 0; ok && i < numAffected; i++) {
+        int a = list[i];
+        for (EdgeList* adjList = in->vertices[a]->adjList; adjList != NULL; adjList = adjList->next) {
+            int x = adjList->edge->toVertex;  // x -> a in 'graph'
+            int distance = addDistance(tree->distances[x], adjList->edge->weight);
+            if (!affected[x] && distance < tree->distances[a]) {
+                tree->distances[a] = distance;
+                tree->predecessors[a] = x;
+                tree->predWeights[a] = adjList->edge->weight;
+            }
+        }
+        if (tree->distances[a] != INT_MAX) {
+            ok = pqPush(heap, tree->distances[a], a);
+        }
+    }
+    // edges that got lighter or were inserted
+    for (int c = 0; ok && c < numChanges; c++) {
+        int u = changes[c].fromVertex;
+        int v = changes[c].toVertex;
+        if (u < 0 || u >= n || v < 0 || v >= n) {
+            continue;
+        }
+        int weight = minEdgeWeight(graph, u, v);
+        int distance = addDistance(tree->distances[u], weight);
+        if (distance < tree->distances[v]) {
+            setTreeEntry(tree, touched, &numTouched, v, distance, u, weight);
+            ok = pqPush(heap, distance, v);
+        }
+    }
+    // Dijkstra from every vertex whose distance changed
+    while (ok && !pqIsEmpty(heap)) {
+        HeapNode node = pqExtractMin(heap);
+        int u = node.id;
+        if (node.priority > tree->distances[u]) {
+            continue;  // stale entry
+        }
+        for (EdgeList* adjList = graph->vertices[u]->adjList; ok && adjList != NULL; adjList = adjList->next) {
+            int v = adjList->edge->toVertex;
+            int distance = addDistance(tree->distances[u], adjList->edge->weight);
+            if (distance < tree->distances[v]) {
+                setTreeEntry(tree, touched, &numTouched, v, distance, u, adjList->edge->weight);
+                ok = pqPush(heap, distance, v);
+            }
+        }
+    }
+    free(affected);
+    free(touched);
+    free(list);
+    deletePQ(heap);
+    return ok ? numTouched : -1;
+}
+
 /*************************************************************************
  ** Provided helper functions -- part of starter code to help you debug!
  *************************************************************************/
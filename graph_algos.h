@@ -0,0 +1,298 @@
+/*
+ * Graph algorithms beyond the ones declared in graph.h.
+ */
+
+#ifndef GRAPH_ALGOS_H
+#define GRAPH_ALGOS_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "arena.h"
+#include "pq.h"
+
+/*
+ * Same as getMSTprim and getDistanceTreeDijkstra, but using a priority
+ * queue of kind 'kind'. getMSTprim and getDistanceTreeDijkstra use
+ * PQ_BINARY_HEAP. Since Prim's keys are not monotone, getMSTprimPQ runs
+ * PQ_RADIX_HEAP requests on PQ_DARY_HEAP instead. Both return NULL on
+ * allocation failure, including a lazy or radix queue failing to grow.
+ */
+Edge* getMSTprimPQ(Graph* graph, int startVertex, PQKind kind);
+Edge* getDistanceTreeDijkstraPQ(Graph* graph, int startVertex, PQKind kind);
+
+/*
+ * A minimum spanning forest: one minimum spanning tree per connected
+ * component. Tree edges have getMSTprim's format (fromVertex is the
+ * vertex the edge was added for, toVertex the tree vertex it hangs
+ * from) and are grouped by component.
+ */
+typedef struct spanningForest
+{
+  int numVertices;
+  int numComponents;
+  int numTreeEdges;             // numVertices - numComponents
+  Edge* treeEdges;
+  int* componentOf;             // componentOf[id] is the component of vertex id
+  int* componentStarts;         // component c owns treeEdges[componentStarts[c]]
+                                //   up to treeEdges[componentStarts[c + 1] - 1]
+  long long* componentWeights;  // total tree weight of each component
+} SpanningForest;
+
+/*
+ * Returns the minimum spanning forest of 'graph', which like getMSTprim
+ * takes every edge to be stored in both directions. Prim's algorithm is
+ * restarted from the lowest unvisited vertex until every vertex is in a
+ * tree; vertices only enter the priority queue once an edge reaches
+ * them, so no vertex is ever queued at INT_MAX. Components are numbered
+ * in order of their lowest vertex.
+ * Returns NULL if 'graph' is NULL or on allocation failure.
+ */
+SpanningForest* getMinimumSpanningForest(Graph* graph);
+void deleteSpanningForest(SpanningForest* forest);
+
+/*
+ * Returns the path from 'vertex' to 'startVertex' in 'distTree', as one
+ * entry of getShortestPaths. 'vertex' must have been reached: an
+ * unreached entry of a getDistanceTreeDijkstra tree is all zeros, which
+ * reads as an edge from vertex 0. Returns NULL on allocation failure.
+ */
+EdgeList* makePath(Edge* distTree, int vertex, int startVertex);
+
+/*
+ * Builds the path from 'vertex' back to 'startVertex' out of the
+ * predecessor and direct edge weight arrays of a search, in the order
+ * of makePath: the first edge leaves 'vertex'. Like makePath it is
+ * calloc'd whatever the current arena is. Returns NULL on allocation
+ * failure.
+ */
+EdgeList* makePathFromPredecessors(int* predecessors, int* predWeights, int vertex,
+                                   int startVertex);
+
+/*
+ * Same as getShortestPaths, but the returned array and every path in it
+ * are allocated from 'arena', so deleteArena or arenaReset frees the
+ * whole result in one call. Returns NULL if 'arena' is NULL.
+ */
+EdgeList** getShortestPathsArena(Edge* distTree, int numVertices, int startVertex,
+                                 Arena* arena);
+
+/*
+ * Returns the shortest path from 'startVertex' to 'targetVertex' in
+ * 'graph', in the same format as the entries of getShortestPaths: the
+ * first edge leaves 'targetVertex' and every edge points towards
+ * 'startVertex'. The search stops as soon as 'targetVertex' is finished
+ * and only touches the vertices it reaches.
+ * Returns NULL if 'targetVertex' is unreachable, equals 'startVertex',
+ * or on invalid arguments or allocation failure.
+ */
+EdgeList* getShortestPath(Graph* graph, int startVertex, int targetVertex);
+
+/*
+ * Creates and returns a new graph with every edge of 'graph' reversed.
+ * Returns NULL if 'graph' is NULL or on allocation failure.
+ */
+Graph* newReverseGraph(Graph* graph);
+
+/*
+ * Same as getShortestPath, but searching forward from 'startVertex' in
+ * 'graph' and backward from 'targetVertex' in 'reverse' (as built by
+ * newReverseGraph) at the same time, always advancing the side with the
+ * smaller frontier key. The search stops once the two minimum keys add
+ * up to at least the best meeting distance found so far. If 'reverse'
+ * is NULL, 'graph' is taken to be undirected and used for both sides.
+ */
+EdgeList* getShortestPathBidirectional(Graph* graph, Graph* reverse,
+                                       int startVertex, int targetVertex);
+
+/*
+ * A lower bound on the distance from 'vertex' to 'targetVertex' in
+ * 'graph'. 'data' is whatever was passed to getShortestPathAStar.
+ */
+typedef int (*Heuristic)(Graph* graph, int vertex, int targetVertex, void* data);
+
+/*
+ * Same as getShortestPath, but ordering the search by distance plus
+ * 'heuristic'. The heuristic must be admissible and consistent (never
+ * overestimate, and drop by at most w along an edge of weight w); a NULL
+ * heuristic gives plain Dijkstra. If 'numSettled' is not NULL, the number
+ * of vertices finished by the search is stored there.
+ */
+EdgeList* getShortestPathAStar(Graph* graph, int startVertex, int targetVertex,
+                               Heuristic heuristic, void* data, int* numSettled);
+
+/*
+ * Per-vertex coordinates, stored in Vertex.value. For haversineDistance
+ * x is the longitude and y the latitude, both in degrees.
+ */
+typedef struct coordinates
+{
+  double x;
+  double y;
+} Coordinates;
+
+typedef double (*Metric)(Coordinates* a, Coordinates* b);
+
+/*
+ * Stores a new Coordinates (x, y) in the value of vertex 'id' of 'graph',
+ * freeing the previous value. Returns false on invalid arguments or
+ * allocation failure.
+ */
+bool setVertexCoordinates(Graph* graph, int id, double x, double y);
+
+double euclideanDistance(Coordinates* a, Coordinates* b);
+double haversineDistance(Coordinates* a, Coordinates* b);  // meters
+
+/*
+ * Returns the largest factor by which 'metric' can be scaled and still
+ * be no more than the weight of any edge of 'graph', i.e. the minimum
+ * weight / length over all edges. Returns 0 if some edge endpoint has no
+ * coordinates.
+ */
+double getAdmissibleScale(Graph* graph, Metric metric);
+
+/*
+ * Heuristics returning scale * metric distance to the target, where
+ * 'scale' points to a double, normally from getAdmissibleScale.
+ */
+int euclideanHeuristic(Graph* graph, int vertex, int targetVertex, void* scale);
+int haversineHeuristic(Graph* graph, int vertex, int targetVertex, void* scale);
+
+/*
+ * Precomputed landmark distances for the ALT heuristic.
+ */
+typedef struct landmarks
+{
+  int numLandmarks;
+  int numVertices;
+  int* ids;            // ids[l] is the vertex ID of landmark l
+  int* fromDistances;  // [l * numVertices + v] is d(landmark l, v)
+  int* toDistances;    // [l * numVertices + v] is d(v, landmark l)
+} Landmarks;           // INT_MAX marks an unreachable pair
+
+/*
+ * Picks 'numLandmarks' landmarks of 'graph' by farthest selection and
+ * computes their distances. 'reverse' is the reverse of 'graph' (see
+ * newReverseGraph), or NULL if 'graph' is undirected.
+ * Returns NULL on invalid arguments or allocation failure.
+ */
+Landmarks* newLandmarks(Graph* graph, Graph* reverse, int numLandmarks);
+void deleteLandmarks(Landmarks* landmarks);
+
+/*
+ * ALT lower bound from the triangle inequality; 'data' is a Landmarks*.
+ */
+int altHeuristic(Graph* graph, int vertex, int targetVertex, void* data);
+
+/*
+ * Runs Dijkstra's algorithm from each of the 'numSources' vertices in
+ * 'sources' on 'numThreads' threads (the calling thread included) and
+ * writes the distances into 'matrix', which has numSources rows of
+ * graph->numVertices entries: matrix[i * numVertices + v] is the
+ * distance from sources[i] to v, INT_MAX if v is unreachable or
+ * sources[i] is not a valid vertex. Each thread keeps one set of records
+ * for all of its runs and only resets what the previous run touched.
+ * Returns false on invalid arguments or allocation failure.
+ */
+bool getDistanceMatrixParallel(Graph* graph, int* sources, int numSources,
+                               int* matrix, int numThreads);
+
+#define DISTANCE_TABLE_UNREACHABLE INT64_MAX
+
+/*
+ * Writes the distance from every vertex in 'sources' to every vertex in
+ * 'targets' into 'table', which has numSources rows of numTargets
+ * entries: table[i * numTargets + j] is the distance from sources[i] to
+ * targets[j], DISTANCE_TABLE_UNREACHABLE if there is no path or either
+ * vertex is invalid. Each search stops once every target is finished,
+ * and all of them share one set of records. Distances are summed in
+ * int64_t, so entries of INT_MAX or more are exact, as in
+ * getDistanceTableCH.
+ * Returns false on invalid arguments or allocation failure.
+ */
+bool getDistanceTable(Graph* graph, int* sources, int numSources, int* targets,
+                      int numTargets, int64_t* table);
+
+/*
+ * The result of a single-source search as three arrays instead of one
+ * EdgeList per vertex. Paths are only built when asked for, by walking
+ * predecessors from the destination, so they cost nothing up front.
+ */
+typedef struct shortestPathTree
+{
+  int numVertices;
+  int startVertex;
+  int* distances;     // distances[id] from startVertex, INT_MAX if unreachable
+  int* predecessors;  // previous vertex on the path to id, -1 if none
+  int* predWeights;   // weight of the edge predecessors[id] -> id
+} ShortestPathTree;
+
+/*
+ * Runs Dijkstra's algorithm on 'graph' from 'startVertex' and returns its
+ * ShortestPathTree. Returns NULL on invalid arguments or allocation
+ * failure.
+ */
+ShortestPathTree* getShortestPathTree(Graph* graph, int startVertex);
+void deleteShortestPathTree(ShortestPathTree* tree);
+
+/*
+ * Returns the number of edges on the path from the start vertex of
+ * 'tree' to 'vertex', or -1 if 'vertex' is invalid or unreachable.
+ */
+int getTreePathLength(ShortestPathTree* tree, int vertex);
+
+/*
+ * Writes the path to 'vertex' into 'buffer' in the format of
+ * getShortestPaths (the first edge leaves 'vertex' and every edge points
+ * towards the start vertex) without allocating. Returns the number of
+ * edges on the path, or -1 if 'vertex' is invalid or unreachable; if that
+ * is more than 'capacity', only the first 'capacity' edges are written.
+ */
+int fillTreePath(ShortestPathTree* tree, int vertex, Edge* buffer, int capacity);
+
+/*
+ * Walks the path to a vertex one edge at a time, in the order of
+ * fillTreePath:
+ *
+ *   PathIterator it;
+ *   Edge edge;
+ *   initPathIterator(&it, tree, vertex);
+ *   while (nextPathEdge(&it, &edge)) { ... }
+ *
+ * The walk is empty if the vertex is invalid, unreachable or the start.
+ */
+typedef struct pathIterator
+{
+  ShortestPathTree* tree;
+  int vertex;             // where the next edge leaves from, -1 when done
+} PathIterator;
+
+void initPathIterator(PathIterator* iterator, ShortestPathTree* tree, int vertex);
+bool nextPathEdge(PathIterator* iterator, Edge* edge);
+
+/*
+ * Returns the path to 'vertex' as an EdgeList, as getShortestPaths would.
+ * Returns NULL if 'vertex' is invalid, unreachable, the start vertex, or
+ * on allocation failure.
+ */
+EdgeList* getTreePath(ShortestPathTree* tree, int vertex);
+
+/*
+ * Brings 'tree', a ShortestPathTree of 'graph', up to date after the
+ * edges in 'changes' were inserted, deleted or reweighted (see
+ * insertEdge, deleteEdge and setEdgeWeight); only fromVertex and
+ * toVertex of each change are used, and every changed directed edge
+ * must be listed. 'reverse' must hold the reverse of the updated graph
+ * (see newReverseGraph), or be NULL if 'graph' is undirected.
+ *
+ * Only the subtrees hanging off edges that got heavier or disappeared
+ * are reset, and only vertices whose distance changes are settled again.
+ * The distances are then those of a full getShortestPathTree; where
+ * several shortest paths exist, the predecessor may differ.
+ * Returns the number of vertices whose entry was reset or lowered, or
+ * -1 on invalid arguments or allocation failure, after which 'tree'
+ * must be rebuilt.
+ */
+int repairShortestPathTree(Graph* graph, Graph* reverse, ShortestPathTree* tree,
+                           Edge* changes, int numChanges);
+
+#endif
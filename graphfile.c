@@ -0,0 +1,232 @@
+/*
+ * Binary graph file format: writing and memory-mapped loading.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "graphfile.h"
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+static uint64_t alignUp(uint64_t pos) {
+    return (pos + 7) & ~(uint64_t)7;
+}
+
+/*
+ * Writes the zero padding that follows a section of 'size' bytes.
+ */
+static bool writePadding(FILE* file, uint64_t size) {
+    static const char padding[8] = {0};
+    uint64_t pad = alignUp(size) - size;
+    return pad == 0 || fwrite(padding, 1, pad, file) == pad;
+}
+
+/*
+ * Writes 'size' bytes of 'data' followed by zero padding up to the next
+ * multiple of 8. Returns false on I/O failure.
+ */
+static bool writeSection(FILE* file, const void* data, uint64_t size) {
+    if (size > 0 && fwrite(data, 1, size, file) != size) {
+        return false;
+    }
+    return writePadding(file, size);
+}
+
+/*
+ * Writes 'csr' and, if 'graph' is not NULL and 'payloadSize' > 0, the
+ * payloads of the vertices of 'graph'.
+ */
+static bool writeFile(CSRGraph* csr, Graph* graph, size_t payloadSize,
+                      const char* path) {
+    if (csr == NULL || path == NULL || payloadSize > UINT32_MAX) {
+        return false;
+    }
+    uint64_t numVertices = (uint64_t)csr->numVertices;
+    uint64_t numEdges = (uint64_t)csr->numEdges;
+
+    GraphFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC));
+    header.version = GRAPH_FILE_VERSION;
+    header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+    header.numVertices = (uint32_t)numVertices;
+    header.numEdges = (uint32_t)numEdges;
+    header.payloadSize = graph != NULL ? (uint32_t)payloadSize : 0;
+    header.offsetsStart = alignUp(sizeof(GraphFileHeader));
+    header.targetsStart = alignUp(header.offsetsStart + (numVertices + 1) * sizeof(int32_t));
+    header.weightsStart = alignUp(header.targetsStart + numEdges * sizeof(int32_t));
+    if (header.payloadSize > 0) {
+        header.payloadsStart = alignUp(header.weightsStart + numEdges * sizeof(int32_t));
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = writeSection(file, &header, sizeof(header))
+        && writeSection(file, csr->offsets, (numVertices + 1) * sizeof(int32_t))
+        && writeSection(file, csr->targets, numEdges * sizeof(int32_t))
+        && writeSection(file, csr->weights, numEdges * sizeof(int32_t));
+    if (ok && header.payloadSize > 0) {
+        unsigned char* zeros = (unsigned char*)calloc(payloadSize, 1);
+        ok = zeros != NULL;
+        for (int id = 0; ok && id < graph->numVertices; id++) {
+            void* value = graph->vertices[id]->value;
+            ok = fwrite(value != NULL ? value : zeros, 1, payloadSize, file) == payloadSize;
+        }
+        free(zeros);
+        ok = ok && writePadding(file, numVertices * payloadSize);
+    }
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        remove(path);
+    }
+    return ok;
+}
+
+/*
+ * Returns true iff the section of 'size' bytes at 'start' lies within a
+ * file of 'length' bytes, after the header and at an aligned offset.
+ */
+static bool sectionFits(uint64_t start, uint64_t size, uint64_t length) {
+    return start >= sizeof(GraphFileHeader) && start % 8 == 0
+        && start <= length && size <= length - start;
+}
+
+/*
+ * Returns true iff 'header' describes a graph file of 'length' bytes
+ * that this version can read.
+ */
+static bool headerIsValid(const GraphFileHeader* header, uint64_t length) {
+    if (memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC)) != 0
+        || header->version != GRAPH_FILE_VERSION
+        || header->byteOrder != GRAPH_FILE_BYTE_ORDER
+        || header->numVertices > INT32_MAX || header->numEdges > INT32_MAX) {
+        return false;
+    }
+    uint64_t numVertices = header->numVertices;
+    uint64_t numEdges = header->numEdges;
+    if (!sectionFits(header->offsetsStart, (numVertices + 1) * sizeof(int32_t), length)
+        || !sectionFits(header->targetsStart, numEdges * sizeof(int32_t), length)
+        || !sectionFits(header->weightsStart, numEdges * sizeof(int32_t), length)) {
+        return false;
+    }
+    if (header->payloadSize > 0) {
+        return sectionFits(header->payloadsStart, numVertices * header->payloadSize, length);
+    }
+    return true;
+}
+
+/*************************************************************************
+ ** Writing
+ *************************************************************************/
+
+bool writeCSRGraphFile(CSRGraph* csr, const char* path) {
+    return writeFile(csr, NULL, 0, path);
+}
+
+bool writeGraphFile(Graph* graph, const char* path, size_t payloadSize) {
+    CSRGraph* csr = newCSRGraph(graph);
+    if (csr == NULL) {
+        return false;
+    }
+    bool ok = writeFile(csr, graph, payloadSize, path);
+    deleteCSRGraph(csr);
+    return ok;
+}
+
+/*************************************************************************
+ ** Loading
+ *************************************************************************/
+
+MappedGraph* mapGraphFile(const char* path) {
+    if (path == NULL) {
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || (uint64_t)info.st_size < sizeof(GraphFileHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)info.st_size;
+    void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    const GraphFileHeader* header = (const GraphFileHeader*)base;
+    MappedGraph* graph = NULL;
+    if (headerIsValid(header, length)) {
+        graph = (MappedGraph*)calloc(1, sizeof(MappedGraph));
+    }
+    if (graph == NULL) {
+        munmap(base, length);
+        return NULL;
+    }
+    unsigned char* bytes = (unsigned char*)base;
+    // CSRGraph is not const-qualified, but the pages are read-only
+    graph->csr.numVertices = (int)header->numVertices;
+    graph->csr.numEdges = (int)header->numEdges;
+    graph->csr.offsets = (int*)(bytes + header->offsetsStart);
+    graph->csr.targets = (int*)(bytes + header->targetsStart);
+    graph->csr.weights = (int*)(bytes + header->weightsStart);
+    if (header->payloadSize > 0) {
+        graph->payloads = bytes + header->payloadsStart;
+        graph->payloadSize = header->payloadSize;
+    }
+    graph->base = base;
+    graph->length = length;
+    return graph;
+}
+
+bool verifyGraphFile(MappedGraph* graph) {
+    if (graph == NULL) {
+        return false;
+    }
+    CSRGraph* csr = &graph->csr;
+    if (csr->offsets[0] != 0 || csr->offsets[csr->numVertices] != csr->numEdges) {
+        return false;
+    }
+    for (int u = 0; u < csr->numVertices; u++) {
+        if (csr->offsets[u] > csr->offsets[u + 1]) {
+            return false;
+        }
+    }
+    for (int i = 0; i < csr->numEdges; i++) {
+        if (csr->targets[i] < 0 || csr->targets[i] >= csr->numVertices) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const void* mappedVertexPayload(MappedGraph* graph, int id) {
+    if (graph == NULL || graph->payloads == NULL
+        || id < 0 || id >= graph->csr.numVertices) {
+        return NULL;
+    }
+    return graph->payloads + (size_t)id * graph->payloadSize;
+}
+
+void unmapGraphFile(MappedGraph* graph) {
+    if (graph != NULL) {
+        munmap(graph->base, graph->length);
+        free(graph);
+    }
+}
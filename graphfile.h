@@ -0,0 +1,90 @@
+/*
+ * Binary graph file format.
+ *
+ * A graph file holds a CSR graph (see csr.h) so that it can be memory
+ * mapped and searched in place:
+ *
+ *   header      GraphFileHeader, 64 bytes
+ *   offsets     int32[numVertices + 1]
+ *   targets     int32[numEdges]
+ *   weights     int32[numEdges]
+ *   payloads    payloadSize bytes per vertex (optional)
+ *
+ * Every section starts at a multiple of 8 bytes, at the file offset
+ * recorded in the header. Integers are in the byte order of the machine
+ * that wrote the file; the byteOrder field lets a reader detect a
+ * mismatch.
+ */
+
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+#include "csr.h"
+
+#define GRAPH_FILE_MAGIC "SPGRAPH"   // 7 characters plus the terminator
+#define GRAPH_FILE_VERSION 1
+#define GRAPH_FILE_BYTE_ORDER 0x01020304u
+
+typedef struct graphFileHeader
+{
+  char magic[8];            // GRAPH_FILE_MAGIC
+  uint32_t version;         // GRAPH_FILE_VERSION
+  uint32_t byteOrder;       // GRAPH_FILE_BYTE_ORDER as written
+  uint32_t numVertices;
+  uint32_t numEdges;
+  uint32_t payloadSize;     // bytes per vertex, 0 if no payload section
+  uint32_t reserved;
+  uint64_t offsetsStart;    // file offsets of the sections
+  uint64_t targetsStart;
+  uint64_t weightsStart;
+  uint64_t payloadsStart;   // 0 if no payload section
+} GraphFileHeader;
+
+/*
+ * A graph file mapped into memory. 'csr' points into the mapping, so it
+ * can be passed to every CSRGraph algorithm but must not be freed with
+ * deleteCSRGraph.
+ */
+typedef struct mappedGraph
+{
+  CSRGraph csr;
+  const unsigned char* payloads;  // NULL if the file has none
+  size_t payloadSize;
+  void* base;                     // start of the mapping
+  size_t length;                  // length of the mapping
+} MappedGraph;
+
+/*
+ * Writes 'csr' / 'graph' to the file at 'path'. For a Graph, the first
+ * 'payloadSize' bytes of every Vertex.value are stored as its payload
+ * (zeros where value is NULL); 0 means no payload section.
+ * Returns false on invalid arguments or I/O failure.
+ */
+bool writeCSRGraphFile(CSRGraph* csr, const char* path);
+bool writeGraphFile(Graph* graph, const char* path, size_t payloadSize);
+
+/*
+ * Maps the graph file at 'path' read-only and returns it. Only the
+ * header and section bounds are checked, so loading does not depend on
+ * the size of the graph; verifyGraphFile checks the contents.
+ * Returns NULL if the file cannot be mapped or is not a valid graph file.
+ */
+MappedGraph* mapGraphFile(const char* path);
+
+/*
+ * Returns true iff every offset of 'graph' is in order and every target
+ * is a valid vertex. Takes time linear in the size of the graph.
+ */
+bool verifyGraphFile(MappedGraph* graph);
+
+/*
+ * Returns the payload of vertex 'id', or NULL if there is none.
+ */
+const void* mappedVertexPayload(MappedGraph* graph, int id);
+
+void unmapGraphFile(MappedGraph* graph);
+
+#endif
@@ -6,6 +6,7 @@
  */
 
 #include "minheap.h"
+#include "stats.h"
 #include <limits.h>
 #define ROOT_INDEX 1
 #define NOTHING -1
@@ -30,25 +31,30 @@ void swap(MinHeap* heap, int index1, int index2){
         heap->arr[index2] = temp;
         heap->indexMap[heap->arr[index1].id] = index1;
         heap->indexMap[heap->arr[index2].id] = index2;
+        STATS_COUNT(heapSiftLevels, 1);
     }
 }
 /*
  * Floats up the element at index 'nodeIndex' in minheap 'heap' such that
- * 'heap' is still a minheap.
+ * 'heap' is still a minheap. The element is held aside while parents
+ * move down into the hole it leaves, so each level costs one move and
+ * one indexMap write instead of a swap.
  * Precondition: 'nodeIndex' is a valid index of minheap 'heap'
  */
 void floatUp(MinHeap* heap, int nodeIndex){
-    while (nodeIndex > 0 ) {
-        int parentIndex = (nodeIndex/2);
-        if (heap->arr[nodeIndex].priority < heap->arr[parentIndex].priority) {
-            // Swap current node with parent
-            swap(heap, nodeIndex, parentIndex);
-            // Update nodeIndex to parent index
-            nodeIndex = parentIndex;
-        } else {
+    HeapNode node = heap->arr[nodeIndex];
+    while (nodeIndex > ROOT_INDEX) {
+        int parentIndex = nodeIndex / 2;
+        if (heap->arr[parentIndex].priority <= node.priority) {
             break;
         }
+        heap->arr[nodeIndex] = heap->arr[parentIndex];
+        heap->indexMap[heap->arr[nodeIndex].id] = nodeIndex;
+        nodeIndex = parentIndex;
+        STATS_COUNT(heapSiftLevels, 1);
     }
+    heap->arr[nodeIndex] = node;
+    heap->indexMap[node.id] = nodeIndex;
 }
 
 /*
@@ -113,20 +119,13 @@ int idAt(MinHeap* heap, int nodeIndex){
 }
 
 /*
- * Returns index of node with ID 'id' in minheap 'heap'.
+ * Returns index of node with ID 'id' in minheap 'heap', or 0 if it is
+ * not in 'heap'.
  * Precondition: 'id' is a valid ID in 'heap'
- *               'heap' is non-empty
  */
 int indexOf(MinHeap* heap, int id){
-    int j=0;
-    if (heap->size > 0) {
-        for (int i = 1; i <= heap->size; i++) {
-            if (heap->arr[i].id == id) {
-                j = i;
-            }
-        }
-    }
-    return j;
+    int index = heap->indexMap[id];
+    return isValidIndex(heap, index) ? index : 0;
 }
 
 /*********************************************************************
@@ -137,39 +136,47 @@ HeapNode getMin(MinHeap* heap)
     return heap->arr[1];
 }
 
+/*
+ * Sinks the element at index 'nodeIndex' in minheap 'heap' below every
+ * child of lower priority, moving children up into the hole as floatUp
+ * moves parents down. Has no effect if 'nodeIndex' is not valid.
+ */
 void heapify(MinHeap* heap, int nodeIndex)
 {
-    // special case for heap of size 1
-    if(heap->size == 1){
-        heap->indexMap[heap->arr[ROOT_INDEX].id] = ROOT_INDEX;
+    if (!isValidIndex(heap, nodeIndex)) {
         return;
     }
-    int leftChildIndex = getLeftChildIdx(nodeIndex);
-    int rightChildIndex = getRightChildIdx(nodeIndex);
-    int smallest = nodeIndex;
-    // Find the smallest among nodeIndex, left child and right child
-    if (leftChildIndex <= heap->size &&
-        heap->arr[leftChildIndex].priority < heap->arr[smallest].priority) {
-        smallest = leftChildIndex;
-    }
-    if (rightChildIndex <= heap->size &&
-        heap->arr[rightChildIndex].priority < heap->arr[smallest].priority) {
-        smallest = rightChildIndex;
-    }
-    //smallest not current node, swap, recursion
-    if (smallest != nodeIndex) {
-        swap(heap, nodeIndex, smallest);
-        heapify(heap, smallest);
+    HeapNode node = heap->arr[nodeIndex];
+    for (;;) {
+        int smallest = getLeftChildIdx(nodeIndex);
+        if (smallest > heap->size) {
+            break;
+        }
+        // the left child wins ties, as it did with the swapping version
+        if (smallest + 1 <= heap->size &&
+            heap->arr[smallest + 1].priority < heap->arr[smallest].priority) {
+            smallest++;
+        }
+        if (heap->arr[smallest].priority >= node.priority) {
+            break;
+        }
+        heap->arr[nodeIndex] = heap->arr[smallest];
+        heap->indexMap[heap->arr[nodeIndex].id] = nodeIndex;
+        nodeIndex = smallest;
+        STATS_COUNT(heapSiftLevels, 1);
     }
+    heap->arr[nodeIndex] = node;
+    heap->indexMap[node.id] = nodeIndex;
 }
 
 HeapNode extractMin(MinHeap* heap)
 {
     HeapNode min = heap->arr[ROOT_INDEX];
+    heap->indexMap[min.id] = NOTHING; // so that it can be inserted again
     heap->arr[ROOT_INDEX] = heap->arr[heap->size];
-    heap->indexMap[heap->arr[ROOT_INDEX].id]=ROOT_INDEX;
     heap->size--;// Reduce heap size
     heapify(heap,ROOT_INDEX);// Restore heap property using heapify
+    STATS_COUNT(heapPops, 1);
     return min;
 
 }
@@ -183,6 +190,7 @@ bool insert(MinHeap* heap, int priority, int id)
     heap->arr[heap->size] = newNode;
     heap->indexMap[id] = heap->size;
     floatUp(heap, heap->size);
+    STATS_COUNT(heapPushes, 1);
     return true;
 }
 
@@ -203,14 +211,40 @@ bool decreasePriority(MinHeap* heap, int id, int newPriority)
         return false;
     }
     int index = heap->indexMap[id];
-    if ( 1<= index && index <= heap->size && getPriority(heap,id)> newPriority){
+    if ( 1<= index && index <= heap->size && heap->arr[index].priority > newPriority){
         heap->arr[index].priority = newPriority;
         floatUp(heap, index);
+        STATS_COUNT(heapDecreases, 1);
         return true;
     }
     return false;
 }
 
+bool decreaseOrInsert(MinHeap* heap, int id, int priority)
+{
+    if (heap == NULL || id < 0 || id >= heap->capacity) {
+        return false;
+    }
+    if (heap->indexMap[id] == NOTHING) {
+        return insert(heap, priority, id);
+    }
+    decreasePriority(heap, id, priority);
+    return true;
+}
+
+void clearTouched(MinHeap* heap)
+{
+    if (heap == NULL) {
+        return;
+    }
+    // extracted ids are cleared by extractMin, so only the ones still in
+    // the heap are left
+    for (int i = ROOT_INDEX; i <= heap->size; i++) {
+        heap->indexMap[heap->arr[i].id] = NOTHING;
+    }
+    heap->size = 0;
+}
+
 /*********************************************************************
  ** Helper function provided in the starter code
  *********************************************************************/
@@ -250,6 +284,29 @@ MinHeap* newHeap(int capacity)
     return heap;
 }
 
+MinHeap* newHeapFromPriorities(const int* priorities, int capacity)
+{
+    if (priorities == NULL) {
+        return NULL;
+    }
+    MinHeap* heap = newHeap(capacity);
+    if (!heap) {
+        return NULL;
+    }
+    for (int id = 0; id < capacity; id++) {
+        heap->arr[id + 1].priority = priorities[id];
+        heap->arr[id + 1].id = id;
+        heap->indexMap[id] = id + 1;
+    }
+    heap->size = capacity;
+    // bottom-up: every subtree below a node is a heap by the time that
+    // node sinks, which is O(capacity) work in total
+    for (int i = getParentIdx(heap->size); i >= ROOT_INDEX; i--) {
+        heapify(heap, i);
+    }
+    return heap;
+}
+
 void deleteHeap(MinHeap* heap)
 {
     if (heap) {
@@ -0,0 +1,91 @@
+/*
+ * Our Priority Queue implementation.
+ *
+ * A binary min-heap of (priority, id) nodes with ids 0..capacity-1,
+ * stored from index 1 of 'arr'. indexMap[id] is the index of id in
+ * 'arr', or -1 if id is not in the heap, so finding, lowering and
+ * testing for an id are O(1).
+ */
+
+#ifndef MINHEAP_H
+#define MINHEAP_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct heap_node
+{
+  int priority;
+  int id;
+} HeapNode;
+
+typedef struct min_heap
+{
+  int size;       // number of nodes, in arr[1] .. arr[size]
+  int capacity;   // ids are 0 .. capacity-1
+  HeapNode* arr;
+  int* indexMap;  // indexMap[id] is the index of id in arr, or -1
+} MinHeap;
+
+/*
+ * Returns the node of lowest priority without removing it.
+ * Precondition: 'heap' is non-empty
+ */
+HeapNode getMin(MinHeap* heap);
+
+/*
+ * Removes and returns the node of lowest priority; its id can then be
+ * inserted again.
+ * Precondition: 'heap' is non-empty
+ */
+HeapNode extractMin(MinHeap* heap);
+
+/*
+ * Adds 'id' with 'priority'.
+ * Precondition: 'id' is valid and not in 'heap'
+ */
+bool insert(MinHeap* heap, int priority, int id);
+
+/*
+ * Returns the priority of 'id', or -1 if it is not in 'heap'.
+ */
+int getPriority(MinHeap* heap, int id);
+
+/*
+ * Lowers the priority of 'id' to 'newPriority'. Returns false, changing
+ * nothing, if 'id' is not in 'heap' or 'newPriority' is no lower.
+ */
+bool decreasePriority(MinHeap* heap, int id, int newPriority);
+
+/*
+ * Inserts 'id' with 'priority' if it is not in 'heap', and otherwise
+ * lowers its priority to 'priority' if that is lower. Returns false only
+ * if 'id' is out of range.
+ */
+bool decreaseOrInsert(MinHeap* heap, int id, int priority);
+
+/*
+ * Empties 'heap' in time proportional to its size rather than its
+ * capacity, so one heap can serve many searches.
+ */
+void clearTouched(MinHeap* heap);
+
+void printHeap(MinHeap* heap);
+
+/*
+ * Returns an empty heap for ids 0 .. capacity-1, or NULL on allocation
+ * failure.
+ */
+MinHeap* newHeap(int capacity);
+
+/*
+ * Returns a heap holding every id 0 .. capacity-1 with priority
+ * priorities[id], built bottom-up in O(capacity) time. Returns NULL if
+ * 'priorities' is NULL or on allocation failure.
+ */
+MinHeap* newHeapFromPriorities(const int* priorities, int capacity);
+
+void deleteHeap(MinHeap* heap);
+
+#endif
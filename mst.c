@@ -0,0 +1,426 @@
+/*
+ * Kruskal and Borůvka minimum spanning tree engines.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "barrier.h"
+#include "mst.h"
+
+// getMST runs Borůvka on several threads from this many edges on
+#define PARALLEL_MIN_EDGES (1 << 18)
+// and considers a graph dense from this many edges per vertex on
+#define DENSE_DEGREE 32
+
+#define NO_EDGE UINT64_MAX
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+/*
+ * Returns a new array of every edge of 'graph' except self-loops and
+ * stores their number in '*numEdges'. Returns NULL on allocation failure.
+ */
+static Edge* collectEdges(Graph* graph, int* numEdges) {
+    // one pass over the lists, which are what costs here; numEdges is
+    // only a hint, so grow if it is short
+    int capacity = graph->numEdges > 0 ? graph->numEdges : 16;
+    Edge* edges = (Edge*)malloc(capacity * sizeof(Edge));
+    if (edges == NULL) {
+        return NULL;
+    }
+    int count = 0;
+    for (int u = 0; u < graph->numVertices; u++) {
+        for (EdgeList* adj = graph->vertices[u]->adjList; adj != NULL; adj = adj->next) {
+            if (adj->edge->toVertex == u) {
+                continue;
+            }
+            if (count == capacity) {
+                capacity *= 2;
+                Edge* grown = (Edge*)realloc(edges, capacity * sizeof(Edge));
+                if (grown == NULL) {
+                    free(edges);
+                    return NULL;
+                }
+                edges = grown;
+            }
+            edges[count++] = *adj->edge;
+        }
+    }
+    *numEdges = count;
+    return edges;
+}
+
+/*
+ * Maps a weight to an unsigned key with the same order.
+ */
+static inline uint32_t weightKey(int weight) {
+    return (uint32_t)weight ^ 0x80000000u;
+}
+
+/*
+ * Sorts 'edges' by weight with an LSD radix sort on bytes, skipping the
+ * bytes on which all keys agree. Returns false on allocation failure.
+ */
+static bool radixSortEdges(Edge* edges, int numEdges) {
+    Edge* buffer = (Edge*)malloc((numEdges + 1) * sizeof(Edge));
+    if (buffer == NULL) {
+        return false;
+    }
+    Edge* from = edges;
+    Edge* to = buffer;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int counts[257] = {0};
+        for (int i = 0; i < numEdges; i++) {
+            counts[((weightKey(from[i].weight) >> shift) & 0xff) + 1]++;
+        }
+        bool skip = false;
+        for (int b = 1; b <= 256; b++) {
+            skip = skip || counts[b] == numEdges;
+        }
+        if (skip) {
+            continue;
+        }
+        for (int b = 0; b < 256; b++) {
+            counts[b + 1] += counts[b];
+        }
+        for (int i = 0; i < numEdges; i++) {
+            to[counts[(weightKey(from[i].weight) >> shift) & 0xff]++] = from[i];
+        }
+        Edge* temp = from;
+        from = to;
+        to = temp;
+    }
+    if (from != edges) {
+        memcpy(edges, from, numEdges * sizeof(Edge));
+    }
+    free(buffer);
+    return true;
+}
+
+/*
+ * Returns the root of 'v' in the union-find 'parents', halving the path
+ * on the way.
+ */
+static int findRoot(int* parents, int v) {
+    while (parents[v] != v) {
+        parents[v] = parents[parents[v]];
+        v = parents[v];
+    }
+    return v;
+}
+
+/*************************************************************************
+ ** Kruskal
+ *************************************************************************/
+
+/*
+ * Kruskal's algorithm over the 'numEdges' 'edges' of a graph of 'n'
+ * vertices. Frees 'edges'.
+ */
+static Edge* runKruskal(Edge* edges, int numEdges, int n, int* numTreeEdges) {
+    int* parents = (int*)malloc(n * sizeof(int));
+    int* sizes = (int*)malloc(n * sizeof(int));
+    Edge* tree = (Edge*)malloc(n * sizeof(Edge));
+    if (parents == NULL || sizes == NULL || tree == NULL ||
+        !radixSortEdges(edges, numEdges)) {
+        free(edges);
+        free(parents);
+        free(sizes);
+        free(tree);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        parents[v] = v;
+        sizes[v] = 1;
+    }
+    int count = 0;
+    for (int i = 0; i < numEdges && count < n - 1; i++) {
+        int a = findRoot(parents, edges[i].fromVertex);
+        int b = findRoot(parents, edges[i].toVertex);
+        if (a == b) {
+            continue;
+        }
+        // union by size keeps the trees shallow
+        if (sizes[a] < sizes[b]) {
+            int temp = a;
+            a = b;
+            b = temp;
+        }
+        parents[b] = a;
+        sizes[a] += sizes[b];
+        tree[count++] = edges[i];
+    }
+    free(edges);
+    free(parents);
+    free(sizes);
+    *numTreeEdges = count;
+    return tree;
+}
+
+Edge* getMSTKruskal(Graph* graph, int* numTreeEdges) {
+    if (graph == NULL || numTreeEdges == NULL) {
+        return NULL;
+    }
+    int numEdges;
+    Edge* edges = collectEdges(graph, &numEdges);
+    if (edges == NULL) {
+        return NULL;
+    }
+    return runKruskal(edges, numEdges, graph->numVertices, numTreeEdges);
+}
+
+/*************************************************************************
+ ** Borůvka
+ *************************************************************************/
+
+/*
+ * State shared by the threads of getMSTBoruvka. Thread t owns edges
+ * sliceStarts[t] .. sliceStarts[t] + sliceSizes[t] - 1 and vertices
+ * t * n / numThreads .. (t + 1) * n / numThreads - 1 for the whole run.
+ * 'previous' and 'done' are only written by thread 0 between barriers.
+ */
+typedef struct boruvkaJob
+{
+  int numVertices;
+  int numThreads;
+  Edge* edges;
+  int* sliceStarts;
+  int* sliceSizes;
+  int* components;         // root of each vertex at the start of a round
+  int* hooks;              // component a root hooks onto, itself if none
+  _Atomic uint64_t* best;  // (weight key, edge index) of a root's lightest edge
+  Edge* tree;
+  atomic_int numTreeEdges;
+  Barrier barrier;
+  int previous;            // numTreeEdges before the current round
+  bool done;               // the last round hooked nothing
+} BoruvkaJob;
+
+typedef struct boruvkaArg
+{
+  BoruvkaJob* job;
+  int id;
+} BoruvkaArg;
+
+static void atomicMin(_Atomic uint64_t* target, uint64_t value) {
+    uint64_t current = atomic_load_explicit(target, memory_order_relaxed);
+    while (value < current &&
+           !atomic_compare_exchange_weak_explicit(target, &current, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+/*
+ * Drops the edges of slice 'id' inside one component and offers the
+ * others to the components at both ends.
+ */
+static void findLightestEdges(BoruvkaJob* job, int id) {
+    Edge* edges = job->edges;
+    int start = job->sliceStarts[id];
+    int end = start + job->sliceSizes[id];
+    int kept = start;
+    for (int i = start; i < end; i++) {
+        int a = job->components[edges[i].fromVertex];
+        int b = job->components[edges[i].toVertex];
+        if (a == b) {
+            continue;
+        }
+        edges[kept] = edges[i];
+        // ties are broken by position, so all components agree on the order
+        uint64_t key = ((uint64_t)weightKey(edges[kept].weight) << 32) | (uint32_t)kept;
+        atomicMin(&job->best[a], key);
+        atomicMin(&job->best[b], key);
+        kept++;
+    }
+    job->sliceSizes[id] = kept - start;
+}
+
+/*
+ * Hooks every root of vertex slice 'id' onto the component at the other
+ * end of its lightest edge. Two components that picked the same edge
+ * would hook onto each other, so only the larger ID does.
+ */
+static void hookComponents(BoruvkaJob* job, int id) {
+    int from = (int)((long)job->numVertices * id / job->numThreads);
+    int to = (int)((long)job->numVertices * (id + 1) / job->numThreads);
+    for (int c = from; c < to; c++) {
+        uint64_t key = atomic_load_explicit(&job->best[c], memory_order_relaxed);
+        if (job->components[c] != c || key == NO_EDGE) {
+            continue;
+        }
+        Edge* edge = &job->edges[(uint32_t)key];
+        int a = job->components[edge->fromVertex];
+        int other = (a == c) ? job->components[edge->toVertex] : a;
+        if (c < other && atomic_load_explicit(&job->best[other], memory_order_relaxed) == key) {
+            continue;
+        }
+        job->hooks[c] = other;
+        job->tree[atomic_fetch_add(&job->numTreeEdges, 1)] = *edge;
+    }
+}
+
+/*
+ * Points every vertex of slice 'id' at the root its component hooked
+ * into and clears the lightest edges for the next round.
+ */
+static void compressComponents(BoruvkaJob* job, int id) {
+    int from = (int)((long)job->numVertices * id / job->numThreads);
+    int to = (int)((long)job->numVertices * (id + 1) / job->numThreads);
+    for (int v = from; v < to; v++) {
+        int root = job->components[v];
+        while (job->hooks[root] != root) {
+            root = job->hooks[root];
+        }
+        job->components[v] = root;
+        atomic_store_explicit(&job->best[v], NO_EDGE, memory_order_relaxed);
+    }
+}
+
+/*
+ * Runs the three phases of every round on slice 'id', with a barrier
+ * after each, until a round hooks nothing.
+ */
+static void* boruvkaWorker(void* arg) {
+    BoruvkaJob* job = ((BoruvkaArg*)arg)->job;
+    int id = ((BoruvkaArg*)arg)->id;
+    for (;;) {
+        barrierWait(&job->barrier);
+        if (job->done) {
+            break;
+        }
+        findLightestEdges(job, id);
+        barrierWait(&job->barrier);
+        hookComponents(job, id);
+        barrierWait(&job->barrier);
+        compressComponents(job, id);
+        barrierWait(&job->barrier);
+        if (id == 0) {
+            // each round that hooks anything at least halves the components
+            int count = atomic_load(&job->numTreeEdges);
+            job->done = count == job->previous;
+            job->previous = count;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Borůvka's algorithm on 'numThreads' threads over the 'numEdges'
+ * 'edges' of a graph of 'n' vertices. Frees 'edges'.
+ */
+static Edge* runBoruvka(Edge* edges, int numEdges, int n, int numThreads,
+                        int* numTreeEdges) {
+    if (numThreads > n) {
+        numThreads = n > 0 ? n : 1;
+    }
+    BoruvkaJob job;
+    job.numVertices = n;
+    job.numThreads = numThreads;
+    job.edges = edges;
+    job.sliceStarts = (int*)malloc(numThreads * sizeof(int));
+    job.sliceSizes = (int*)malloc(numThreads * sizeof(int));
+    job.components = (int*)malloc(n * sizeof(int));
+    job.hooks = (int*)malloc(n * sizeof(int));
+    job.best = (_Atomic uint64_t*)malloc(n * sizeof(_Atomic uint64_t));
+    job.tree = (Edge*)malloc(n * sizeof(Edge));
+    atomic_init(&job.numTreeEdges, 0);
+    BoruvkaArg* args = (BoruvkaArg*)malloc(numThreads * sizeof(BoruvkaArg));
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    bool ok = job.sliceStarts != NULL && job.sliceSizes != NULL && job.components != NULL &&
+              job.hooks != NULL && job.best != NULL && job.tree != NULL && args != NULL &&
+              threads != NULL;
+    if (ok) {
+        for (int v = 0; v < n; v++) {
+            job.components[v] = v;
+            job.hooks[v] = v;
+            atomic_init(&job.best[v], NO_EDGE);
+        }
+        job.previous = 0;
+        job.done = false;
+        barrierInit(&job.barrier, numThreads);
+        int numStarted = 0;
+        for (int t = 1; t < numThreads; t++) {
+            args[t].job = &job;
+            args[t].id = t;
+            if (pthread_create(&threads[t], NULL, boruvkaWorker, &args[t]) != 0) {
+                break;
+            }
+            numStarted++;
+        }
+        // as in delta-stepping, the started threads wait at the first
+        // barrier until this one arrives, so the slices can still be
+        // cut for however many there are
+        pthread_mutex_lock(&job.barrier.mutex);
+        job.barrier.count = numStarted + 1;
+        job.numThreads = numStarted + 1;
+        pthread_mutex_unlock(&job.barrier.mutex);
+        for (int t = 0; t < job.numThreads; t++) {
+            job.sliceStarts[t] = (int)((long)numEdges * t / job.numThreads);
+            job.sliceSizes[t] = (int)((long)numEdges * (t + 1) / job.numThreads) -
+                                job.sliceStarts[t];
+        }
+        args[0].job = &job;
+        args[0].id = 0;
+        boruvkaWorker(&args[0]);
+        for (int t = 1; t <= numStarted; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        barrierDestroy(&job.barrier);
+    }
+    free(job.edges);
+    free(job.sliceStarts);
+    free(job.sliceSizes);
+    free(job.components);
+    free(job.hooks);
+    free((void*)job.best);
+    free(args);
+    free(threads);
+    if (!ok) {
+        free(job.tree);
+        return NULL;
+    }
+    *numTreeEdges = atomic_load(&job.numTreeEdges);
+    return job.tree;
+}
+
+Edge* getMSTBoruvka(Graph* graph, int numThreads, int* numTreeEdges) {
+    if (graph == NULL || numTreeEdges == NULL || numThreads <= 0) {
+        return NULL;
+    }
+    int numEdges;
+    Edge* edges = collectEdges(graph, &numEdges);
+    if (edges == NULL) {
+        return NULL;
+    }
+    return runBoruvka(edges, numEdges, graph->numVertices, numThreads, numTreeEdges);
+}
+
+/*************************************************************************
+ ** Engine selection
+ *************************************************************************/
+
+Edge* getMST(Graph* graph, int numThreads, int* numTreeEdges) {
+    if (graph == NULL || numTreeEdges == NULL || numThreads <= 0) {
+        return NULL;
+    }
+    // graph->numEdges is only a hint, so choose on the edges found
+    int n = graph->numVertices;
+    int numEdges;
+    Edge* edges = collectEdges(graph, &numEdges);
+    if (edges == NULL) {
+        return NULL;
+    }
+    if (numThreads > 1 && numEdges >= PARALLEL_MIN_EDGES) {
+        return runBoruvka(edges, numEdges, n, numThreads, numTreeEdges);
+    }
+    if ((long)numEdges >= (long)DENSE_DEGREE * n) {
+        return runBoruvka(edges, numEdges, n, 1, numTreeEdges);
+    }
+    return runKruskal(edges, numEdges, n, numTreeEdges);
+}
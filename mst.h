@@ -0,0 +1,42 @@
+/*
+ * Minimum spanning tree engines besides getMSTprim.
+ *
+ * Edge directions are ignored: every edge u -> v is taken to connect u
+ * and v, so an undirected graph stored with both directions works as
+ * is. Unlike getMSTprim, which only spans the component of its start
+ * vertex, these engines span every component (a minimum spanning
+ * forest). They return an array of the tree edges as found in the graph,
+ * store how many there are in '*numTreeEdges', and return NULL on invalid
+ * arguments or allocation failure. On a connected graph every engine
+ * gives a tree of the same total weight as getMSTprim, though the edges
+ * may differ where weights tie.
+ */
+
+#ifndef MST_H
+#define MST_H
+
+#include "graph.h"
+
+/*
+ * Kruskal's algorithm: radix-sorts the edges by weight and adds them in
+ * order through a union-find with path compression.
+ */
+Edge* getMSTKruskal(Graph* graph, int* numTreeEdges);
+
+/*
+ * Borůvka's algorithm on 'numThreads' threads (the calling thread
+ * included). In every round each component picks its lightest outgoing
+ * edge with an atomic minimum and hooks itself onto the component at the
+ * other end, so the number of components at least halves per round.
+ */
+Edge* getMSTBoruvka(Graph* graph, int numThreads, int* numTreeEdges);
+
+/*
+ * Picks an engine for 'graph' and 'numThreads': Borůvka when there are
+ * threads to spread it over and edges enough to pay for them, otherwise
+ * Kruskal on sparse graphs and single-threaded Borůvka on dense ones,
+ * where sorting every edge costs more than a few filtering rounds.
+ */
+Edge* getMST(Graph* graph, int numThreads, int* numTreeEdges);
+
+#endif
@@ -0,0 +1,444 @@
+/*
+ * Priority queue backends for Prim's and Dijkstra's algorithms.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "pq.h"
+#include "search_queue.h"
+#include "stats.h"
+
+#define DARY_ARITY 4
+#define RADIX_BUCKETS 33  // one bucket per bit of a 32-bit key, plus one
+#define NOTHING -1
+
+/*
+ * A growable array of HeapNodes, one per radix heap bucket.
+ */
+typedef struct nodeArray
+{
+  int size;
+  int capacity;
+  HeapNode* arr;
+} NodeArray;
+
+DEFINE_SEARCH_QUEUE_LAZY(LazyQueue, int)
+
+struct priorityQueue
+{
+  PQKind kind;
+  int capacity;         // ids are 0, 1, ..., capacity-1
+  int size;             // number of entries, duplicates included
+  MinHeap* heap;        // PQ_BINARY_HEAP
+  HeapNode* arr;        // PQ_DARY_HEAP, 0-based
+  int* indexMap;        // PQ_DARY_HEAP, index of id in arr or NOTHING
+  LazyQueue lazy;       // PQ_LAZY_HEAP
+  NodeArray buckets[RADIX_BUCKETS];  // PQ_RADIX_HEAP
+  unsigned int last;    // PQ_RADIX_HEAP, last extracted priority
+};
+
+/*************************************************************************
+ ** NodeArray helpers
+ *************************************************************************/
+
+static bool nodeArrayPush(NodeArray* a, HeapNode node) {
+    if (a->size == a->capacity) {
+        int newCapacity = a->capacity == 0 ? 16 : 2 * a->capacity;
+        HeapNode* arr = (HeapNode*)realloc(a->arr, newCapacity * sizeof(HeapNode));
+        if (arr == NULL) {
+            return false;
+        }
+        a->arr = arr;
+        a->capacity = newCapacity;
+    }
+    a->arr[a->size++] = node;
+    return true;
+}
+
+/*************************************************************************
+ ** PQ_DARY_HEAP
+ *************************************************************************/
+
+/*
+ * Moves the node at 'index' up until its parent is not larger. The node
+ * is held aside and parents are shifted down into the hole, so
+ * indexMap is written once per level.
+ */
+static void daryFloatUp(PriorityQueue* pq, int index) {
+    HeapNode node = pq->arr[index];
+    while (index > 0) {
+        int parent = (index - 1) / DARY_ARITY;
+        if (pq->arr[parent].priority <= node.priority) {
+            break;
+        }
+        pq->arr[index] = pq->arr[parent];
+        pq->indexMap[pq->arr[index].id] = index;
+        index = parent;
+        STATS_COUNT(heapSiftLevels, 1);
+    }
+    pq->arr[index] = node;
+    pq->indexMap[node.id] = index;
+}
+
+static void darySiftDown(PriorityQueue* pq, int index) {
+    HeapNode node = pq->arr[index];
+    for (;;) {
+        int first = DARY_ARITY * index + 1;
+        if (first >= pq->size) {
+            break;
+        }
+        int last = first + DARY_ARITY < pq->size ? first + DARY_ARITY : pq->size;
+        int smallest = first;
+        for (int c = first + 1; c < last; c++) {
+            if (pq->arr[c].priority < pq->arr[smallest].priority) {
+                smallest = c;
+            }
+        }
+        if (pq->arr[smallest].priority >= node.priority) {
+            break;
+        }
+        pq->arr[index] = pq->arr[smallest];
+        pq->indexMap[pq->arr[index].id] = index;
+        index = smallest;
+        STATS_COUNT(heapSiftLevels, 1);
+    }
+    pq->arr[index] = node;
+    pq->indexMap[node.id] = index;
+}
+
+static bool daryPush(PriorityQueue* pq, int priority, int id) {
+    int index = pq->indexMap[id];
+    if (index == NOTHING) {
+        pq->arr[pq->size] = (HeapNode){priority, id};
+        pq->size++;
+        daryFloatUp(pq, pq->size - 1);
+        STATS_COUNT(heapPushes, 1);
+    } else if (priority < pq->arr[index].priority) {
+        pq->arr[index].priority = priority;
+        daryFloatUp(pq, index);
+        STATS_COUNT(heapDecreases, 1);
+    }
+    return true;
+}
+
+static HeapNode daryExtractMin(PriorityQueue* pq) {
+    HeapNode min = pq->arr[0];
+    pq->indexMap[min.id] = NOTHING;
+    pq->size--;
+    STATS_COUNT(heapPops, 1);
+    if (pq->size > 0) {
+        pq->arr[0] = pq->arr[pq->size];
+        darySiftDown(pq, 0);
+    }
+    return min;
+}
+
+/*************************************************************************
+ ** PQ_LAZY_HEAP
+ *************************************************************************/
+
+static bool lazyPush(PriorityQueue* pq, int priority, int id) {
+    if (!LazyQueuePush(&pq->lazy, priority, id)) {
+        return false;
+    }
+    pq->size++;
+    return true;
+}
+
+static HeapNode lazyGetMin(PriorityQueue* pq) {
+    HeapNode min = {pq->lazy.entries[0].key, pq->lazy.entries[0].id};
+    return min;
+}
+
+static HeapNode lazyExtractMin(PriorityQueue* pq) {
+    HeapNode min;
+    min.id = LazyQueuePop(&pq->lazy, &min.priority);
+    pq->size--;
+    return min;
+}
+
+/*************************************************************************
+ ** PQ_RADIX_HEAP
+ *************************************************************************/
+
+/*
+ * Returns the bucket for 'key': 0 if it equals the last extracted key,
+ * otherwise 1 + the position of the highest bit in which they differ.
+ */
+static int radixBucket(PriorityQueue* pq, unsigned int key) {
+    unsigned int diff = key ^ pq->last;
+    return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+}
+
+static bool radixPush(PriorityQueue* pq, int priority, int id) {
+    if (priority < 0 || (unsigned int)priority < pq->last) {
+        return false;  // radix heap needs monotone non-negative keys
+    }
+    HeapNode node = {priority, id};
+    if (!nodeArrayPush(&pq->buckets[radixBucket(pq, (unsigned int)priority)], node)) {
+        return false;
+    }
+    pq->size++;
+    STATS_COUNT(heapPushes, 1);
+    return true;
+}
+
+/*
+ * Makes sure bucket 0 holds the minimum: if it is empty, the smallest
+ * key of the first non-empty bucket becomes the new 'last' and every
+ * entry of that bucket moves to a strictly lower bucket. Returns false
+ * on allocation failure, leaving 'pq' as it was.
+ * Precondition: 'pq' is not empty.
+ */
+static bool radixRefill(PriorityQueue* pq) {
+    if (pq->buckets[0].size > 0) {
+        return true;
+    }
+    int b = 1;
+    while (pq->buckets[b].size == 0) {
+        b++;
+    }
+    NodeArray* from = &pq->buckets[b];
+    unsigned int min = (unsigned int)from->arr[0].priority;
+    for (int i = 1; i < from->size; i++) {
+        if ((unsigned int)from->arr[i].priority < min) {
+            min = (unsigned int)from->arr[i].priority;
+        }
+    }
+    unsigned int previous = pq->last;
+    pq->last = min;
+    for (int i = 0; i < from->size; i++) {
+        NodeArray* to = &pq->buckets[radixBucket(pq, (unsigned int)from->arr[i].priority)];
+        if (!nodeArrayPush(to, from->arr[i])) {
+            // buckets below b were empty and 'from' still holds every
+            // entry, so emptying them again undoes the partial move
+            for (int k = 0; k < b; k++) {
+                pq->buckets[k].size = 0;
+            }
+            pq->last = previous;
+            return false;
+        }
+    }
+    from->size = 0;
+    return true;
+}
+
+static HeapNode radixExtractMin(PriorityQueue* pq) {
+    if (!radixRefill(pq)) {
+        HeapNode none = {INT_MAX, NOTHING};
+        return none;
+    }
+    pq->size--;
+    STATS_COUNT(heapPops, 1);
+    return pq->buckets[0].arr[--pq->buckets[0].size];
+}
+
+/*************************************************************************
+ ** Public interface
+ *************************************************************************/
+
+PriorityQueue* newPQ(PQKind kind, int capacity) {
+    if (capacity < 0) {
+        return NULL;
+    }
+    PriorityQueue* pq = (PriorityQueue*)calloc(1, sizeof(PriorityQueue));
+    if (pq == NULL) {
+        return NULL;
+    }
+    pq->kind = kind;
+    pq->capacity = capacity;
+    switch (kind) {
+        case PQ_BINARY_HEAP:
+            pq->heap = newHeap(capacity);
+            if (pq->heap == NULL) {
+                free(pq);
+                return NULL;
+            }
+            break;
+        case PQ_DARY_HEAP:
+            pq->arr = (HeapNode*)malloc((capacity + 1) * sizeof(HeapNode));
+            pq->indexMap = (int*)malloc((capacity + 1) * sizeof(int));
+            if (pq->arr == NULL || pq->indexMap == NULL) {
+                deletePQ(pq);
+                return NULL;
+            }
+            for (int i = 0; i < capacity; i++) {
+                pq->indexMap[i] = NOTHING;
+            }
+            break;
+        case PQ_LAZY_HEAP:
+            if (!LazyQueueInit(&pq->lazy, capacity)) {
+                free(pq);
+                return NULL;
+            }
+            break;
+        case PQ_RADIX_HEAP:
+            // grown on demand, nothing is sized by capacity
+            break;
+        default:
+            free(pq);
+            return NULL;
+    }
+    return pq;
+}
+
+PriorityQueue* newPQFromHeap(MinHeap* heap) {
+    if (heap == NULL) {
+        return NULL;
+    }
+    PriorityQueue* pq = (PriorityQueue*)calloc(1, sizeof(PriorityQueue));
+    if (pq == NULL) {
+        return NULL;
+    }
+    pq->kind = PQ_BINARY_HEAP;
+    pq->capacity = heap->capacity;
+    pq->heap = heap;
+    return pq;
+}
+
+void deletePQ(PriorityQueue* pq) {
+    if (!pq) return;
+    deleteHeap(pq->heap);
+    free(pq->arr);
+    free(pq->indexMap);
+    LazyQueueFree(&pq->lazy);
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+        free(pq->buckets[b].arr);
+    }
+    free(pq);
+}
+
+PQKind pqKind(PriorityQueue* pq) {
+    return pq->kind;
+}
+
+const char* pqKindName(PQKind kind) {
+    switch (kind) {
+        case PQ_BINARY_HEAP: return "binary";
+        case PQ_DARY_HEAP:   return "4-ary";
+        case PQ_LAZY_HEAP:   return "lazy";
+        case PQ_RADIX_HEAP:  return "radix";
+    }
+    return "unknown";
+}
+
+bool pqIsEmpty(PriorityQueue* pq) {
+    if (pq == NULL) {
+        return true;
+    }
+    if (pq->kind == PQ_BINARY_HEAP) {
+        return pq->heap->size == 0;
+    }
+    return pq->size == 0;
+}
+
+bool pqPush(PriorityQueue* pq, int priority, int id) {
+    if (pq == NULL || id < 0 || id >= pq->capacity) {
+        return false;
+    }
+    switch (pq->kind) {
+        case PQ_BINARY_HEAP:
+            return decreaseOrInsert(pq->heap, id, priority);
+        case PQ_DARY_HEAP:
+            return daryPush(pq, priority, id);
+        case PQ_LAZY_HEAP:
+            return lazyPush(pq, priority, id);
+        case PQ_RADIX_HEAP:
+            return radixPush(pq, priority, id);
+    }
+    return false;
+}
+
+HeapNode pqExtractMin(PriorityQueue* pq) {
+    switch (pq->kind) {
+        case PQ_BINARY_HEAP:
+            return extractMin(pq->heap);
+        case PQ_DARY_HEAP:
+            return daryExtractMin(pq);
+        case PQ_LAZY_HEAP:
+            return lazyExtractMin(pq);
+        case PQ_RADIX_HEAP:
+            return radixExtractMin(pq);
+    }
+    HeapNode none = {INT_MAX, NOTHING};
+    return none;
+}
+
+void pqClear(PriorityQueue* pq) {
+    if (pq == NULL) {
+        return;
+    }
+    switch (pq->kind) {
+        case PQ_BINARY_HEAP:
+            clearTouched(pq->heap);
+            break;
+        case PQ_DARY_HEAP:
+            for (int i = 0; i < pq->size; i++) {
+                pq->indexMap[pq->arr[i].id] = NOTHING;
+            }
+            break;
+        case PQ_LAZY_HEAP:
+            LazyQueueClear(&pq->lazy);
+            break;
+        case PQ_RADIX_HEAP:
+            for (int b = 0; b < RADIX_BUCKETS; b++) {
+                pq->buckets[b].size = 0;
+            }
+            pq->last = 0;
+            break;
+    }
+    pq->size = 0;
+}
+
+HeapNode pqGetMin(PriorityQueue* pq) {
+    switch (pq->kind) {
+        case PQ_BINARY_HEAP:
+            return getMin(pq->heap);
+        case PQ_DARY_HEAP:
+            return pq->arr[0];
+        case PQ_LAZY_HEAP:
+            return lazyGetMin(pq);
+        case PQ_RADIX_HEAP:
+            if (!radixRefill(pq)) {
+                break;
+            }
+            return pq->buckets[0].arr[pq->buckets[0].size - 1];
+    }
+    HeapNode none = {INT_MAX, NOTHING};
+    return none;
+}
+
+void printPQ(PriorityQueue* pq) {
+    if (pq == NULL) {
+        printf("NULL\n");
+        return;
+    }
+    if (pq->kind == PQ_BINARY_HEAP) {
+        printHeap(pq->heap);
+        return;
+    }
+    printf("%s PQ with size: %d\n\tcapacity: %d\n\n", pqKindName(pq->kind),
+           pq->size, pq->capacity);
+    printf("priority [ID]\n");
+    switch (pq->kind) {
+        case PQ_DARY_HEAP:
+            for (int i = 0; i < pq->size; i++)
+                printf("%d: %d [%d]\n", i, pq->arr[i].priority, pq->arr[i].id);
+            break;
+        case PQ_LAZY_HEAP:
+            for (int i = 0; i < pq->lazy.size; i++)
+                printf("%d: %d [%d]\n", i, pq->lazy.entries[i].key, pq->lazy.entries[i].id);
+            break;
+        case PQ_RADIX_HEAP:
+            printf("last extracted: %u\n", pq->last);
+            for (int b = 0; b < RADIX_BUCKETS; b++)
+                for (int i = 0; i < pq->buckets[b].size; i++)
+                    printf("bucket %d: %d [%d]\n", b, pq->buckets[b].arr[i].priority,
+                           pq->buckets[b].arr[i].id);
+            break;
+        default:
+            break;
+    }
+    printf("\n\n");
+}
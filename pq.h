@@ -0,0 +1,94 @@
+/*
+ * Pluggable priority queue used by Prim's and Dijkstra's algorithms.
+ *
+ * Every backend stores HeapNodes (priority, id) and supports the same
+ * push / extract-min interface:
+ *
+ *   PQ_BINARY_HEAP  the indexed binary MinHeap from minheap.c.
+ *   PQ_DARY_HEAP    an indexed 4-ary heap; shallower than the binary
+ *                   heap and sifts by moving a hole instead of swapping.
+ *   PQ_LAZY_HEAP    a non-indexed binary heap that only holds the ids
+ *                   pushed so far. A push never updates an existing
+ *                   entry, it adds a new one (lazy deletion).
+ *   PQ_RADIX_HEAP   a monotone radix heap for non-negative priorities.
+ *                   Like PQ_LAZY_HEAP it keeps duplicates, and a push
+ *                   must not be smaller than the last extracted
+ *                   priority.
+ *
+ * With the lazy backends an id may be extracted more than once; callers
+ * must skip ids they have already finished.
+ */
+
+#ifndef PQ_H
+#define PQ_H
+
+#include <stdbool.h>
+#include "minheap.h"
+
+typedef enum pqKind
+{
+  PQ_BINARY_HEAP,
+  PQ_DARY_HEAP,
+  PQ_LAZY_HEAP,
+  PQ_RADIX_HEAP
+} PQKind;
+
+typedef struct priorityQueue PriorityQueue;
+
+/*
+ * Creates and returns an empty priority queue of kind 'kind' for ids
+ * 0, 1, ..., capacity-1. Returns NULL on allocation failure.
+ */
+PriorityQueue* newPQ(PQKind kind, int capacity);
+
+/*
+ * Creates and returns a PQ_BINARY_HEAP queue that takes ownership of
+ * the already populated 'heap'. Returns NULL on allocation failure, in
+ * which case 'heap' is left untouched.
+ */
+PriorityQueue* newPQFromHeap(MinHeap* heap);
+
+void deletePQ(PriorityQueue* pq);
+
+PQKind pqKind(PriorityQueue* pq);
+const char* pqKindName(PQKind kind);
+
+/*
+ * Returns true iff 'pq' is NULL or holds no entries.
+ */
+bool pqIsEmpty(PriorityQueue* pq);
+
+/*
+ * Inserts 'id' with 'priority' into 'pq'. If the backend is indexed and
+ * 'id' is already in 'pq', its priority is lowered to 'priority'
+ * instead (and left alone if it is not lower).
+ * Returns false if 'id' is out of range or 'priority' is not valid for
+ * the backend.
+ */
+bool pqPush(PriorityQueue* pq, int priority, int id);
+
+/*
+ * Removes and returns the entry with the smallest priority.
+ * A PQ_RADIX_HEAP may need memory to find it; on allocation failure
+ * the entry {INT_MAX, -1} is returned and 'pq' is left unchanged.
+ * Precondition: 'pq' is not empty.
+ */
+HeapNode pqExtractMin(PriorityQueue* pq);
+
+/*
+ * Removes every entry from 'pq' in time proportional to the number of
+ * entries, so one queue can be reused across many searches.
+ */
+void pqClear(PriorityQueue* pq);
+
+/*
+ * Returns the entry with the smallest priority without removing it.
+ * With the lazy backends this may be a stale entry. Returns {INT_MAX,
+ * -1} on allocation failure, like pqExtractMin.
+ * Precondition: 'pq' is not empty.
+ */
+HeapNode pqGetMin(PriorityQueue* pq);
+
+void printPQ(PriorityQueue* pq);
+
+#endif
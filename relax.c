@@ -0,0 +1,233 @@
+/*
+ * Vectorized edge relaxation over CSR adjacency arrays.
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include "relax.h"
+#include "pq.h"
+
+// the AVX2 and AVX-512 kernels are compiled with per-function target
+// attributes, so the rest of the build needs no -m flags
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// vertices of lower degree are relaxed inline, where a kernel call and
+// its index list cost more than they save
+#define VECTOR_MIN_DEGREE 8
+
+/*************************************************************************
+ ** Kernels
+ *************************************************************************/
+
+static int relaxScalar(const int* targets, const int* weights, int count, int distance,
+                       const int* distances, int* improved) {
+    int numImproved = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned int candidate = (unsigned int)distance + (unsigned int)weights[i];
+        // written unconditionally, kept only if it improves: no branch
+        improved[numImproved] = i;
+        numImproved += candidate < (unsigned int)distances[targets[i]];
+    }
+    return numImproved;
+}
+
+#ifdef HAVE_X86_KERNELS
+
+__attribute__((target("avx2")))
+static int relaxAVX2(const int* targets, const int* weights, int count, int distance,
+                     const int* distances, int* improved) {
+    __m256i base = _mm256_set1_epi32(distance);
+    int numImproved = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i target = _mm256_loadu_si256((const __m256i*)(targets + i));
+        __m256i weight = _mm256_loadu_si256((const __m256i*)(weights + i));
+        __m256i candidate = _mm256_add_epi32(base, weight);
+        __m256i current = _mm256_i32gather_epi32(distances, target, 4);
+        // AVX2 has no unsigned less-than: candidate < current iff the
+        // unsigned maximum of the two is not the candidate
+        __m256i notLess = _mm256_cmpeq_epi32(_mm256_max_epu32(candidate, current), candidate);
+        unsigned int mask = ~(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(notLess)) & 0xFF;
+        while (mask != 0) {
+            improved[numImproved++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    int tail = relaxScalar(targets + i, weights + i, count - i, distance, distances,
+                           improved + numImproved);
+    for (int k = numImproved; k < numImproved + tail; k++) {
+        improved[k] += i;
+    }
+    return numImproved + tail;
+}
+
+__attribute__((target("avx512f")))
+static int relaxAVX512(const int* targets, const int* weights, int count, int distance,
+                       const int* distances, int* improved) {
+    __m512i base = _mm512_set1_epi32(distance);
+    __m512i lanes = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    int numImproved = 0;
+    for (int i = 0; i < count; i += 16) {
+        // the last block is masked rather than finished in scalar code
+        __mmask16 live = count - i >= 16 ? (__mmask16)0xFFFF
+                                         : (__mmask16)((1u << (count - i)) - 1);
+        __m512i target = _mm512_maskz_loadu_epi32(live, targets + i);
+        __m512i weight = _mm512_maskz_loadu_epi32(live, weights + i);
+        __m512i candidate = _mm512_add_epi32(base, weight);
+        __m512i current = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, target,
+                                                      distances, 4);
+        __mmask16 better = _mm512_mask_cmplt_epu32_mask(live, candidate, current);
+        __m512i index = _mm512_add_epi32(lanes, _mm512_set1_epi32(i));
+        _mm512_mask_compressstoreu_epi32(improved + numImproved, better, index);
+        numImproved += __builtin_popcount((unsigned int)better);
+    }
+    return numImproved;
+}
+
+#endif
+
+bool hasRelaxKernel(RelaxKernel kernel) {
+    switch (kernel) {
+        case RELAX_AUTO:
+        case RELAX_SCALAR:
+            return true;
+#ifdef HAVE_X86_KERNELS
+        case RELAX_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case RELAX_AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+RelaxKernel getBestRelaxKernel(void) {
+    if (hasRelaxKernel(RELAX_AVX512)) {
+        return RELAX_AVX512;
+    }
+    return hasRelaxKernel(RELAX_AVX2) ? RELAX_AVX2 : RELAX_SCALAR;
+}
+
+const char* relaxKernelName(RelaxKernel kernel) {
+    switch (kernel) {
+        case RELAX_AUTO:
+            return "auto";
+        case RELAX_SCALAR:
+            return "scalar";
+        case RELAX_AVX2:
+            return "avx2";
+        case RELAX_AVX512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+int relaxCandidates(RelaxKernel kernel, const int* targets, const int* weights, int count,
+                    int distance, const int* distances, int* improved) {
+    if (kernel == RELAX_AUTO) {
+        kernel = getBestRelaxKernel();
+    }
+    switch (kernel) {
+#ifdef HAVE_X86_KERNELS
+        case RELAX_AVX2:
+            return relaxAVX2(targets, weights, count, distance, distances, improved);
+        case RELAX_AVX512:
+            return relaxAVX512(targets, weights, count, distance, distances, improved);
+#endif
+        default:
+            return relaxScalar(targets, weights, count, distance, distances, improved);
+    }
+}
+
+/*************************************************************************
+ ** Dijkstra
+ *************************************************************************/
+
+/*
+ * Lowers the distance of 'v' to 'candidate' if that is an improvement,
+ * recording 'u' as its predecessor. 'candidate' is an unsigned sum of a
+ * distance and a weight, so one that does not fit in an int never is.
+ */
+static inline void relaxVector(PriorityQueue* heap, int* distances, Edge* distTree, int u,
+                               int v, unsigned int candidate) {
+    if (candidate < (unsigned int)distances[v]) {
+        distances[v] = (int)candidate;
+        pqPush(heap, (int)candidate, v);
+        distTree[v].fromVertex = u;
+        distTree[v].toVertex = v;
+        distTree[v].weight = (int)candidate;
+    }
+}
+
+Edge* getDistanceTreeDijkstraVector(CSRGraph* csr, int startVertex, RelaxKernel kernel) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices) {
+        return NULL;
+    }
+    if (kernel == RELAX_AUTO) {
+        kernel = getBestRelaxKernel();
+    }
+    if (!hasRelaxKernel(kernel)) {
+        return NULL;
+    }
+    int n = csr->numVertices;
+    int maxDegree = 0;
+    for (int u = 0; u < n; u++) {
+        int degree = csr->offsets[u + 1] - csr->offsets[u];
+        maxDegree = degree > maxDegree ? degree : maxDegree;
+    }
+    // non-negative weights mean that a settled vertex can never improve,
+    // so there is no need for a finished array
+    for (int i = 0; i < csr->numEdges; i++) {
+        if (csr->weights[i] < 0) {
+            return NULL;
+        }
+    }
+    PriorityQueue* heap = newPQ(PQ_DARY_HEAP, n);
+    int* distances = (int*)malloc(n * sizeof(int));
+    int* improved = (int*)malloc((maxDegree + 1) * sizeof(int));
+    Edge* distTree = (Edge*)calloc(n, sizeof(Edge));
+    if (heap == NULL || distances == NULL || improved == NULL || distTree == NULL) {
+        deletePQ(heap);
+        free(distances);
+        free(improved);
+        free(distTree);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        distances[i] = INT_MAX;
+    }
+    distances[startVertex] = 0;
+    pqPush(heap, 0, startVertex);
+    while (!pqIsEmpty(heap)) {
+        int u = pqExtractMin(heap).id;
+        unsigned int du = (unsigned int)distances[u];
+        int first = csr->offsets[u];
+        int degree = csr->offsets[u + 1] - first;
+        const int* targets = csr->targets + first;
+        const int* weights = csr->weights + first;
+        if (degree >= VECTOR_MIN_DEGREE) {
+            int numImproved = relaxCandidates(kernel, targets, weights, degree, (int)du,
+                                              distances, improved);
+            for (int k = 0; k < numImproved; k++) {
+                int i = improved[k];
+                relaxVector(heap, distances, distTree, u, targets[i], du + (unsigned int)weights[i]);
+            }
+        } else {
+            for (int i = 0; i < degree; i++) {
+                relaxVector(heap, distances, distTree, u, targets[i], du + (unsigned int)weights[i]);
+            }
+        }
+    }
+    // to match getDistanceTreeDijkstra
+    distTree[startVertex].fromVertex = startVertex;
+    distTree[startVertex].toVertex = startVertex;
+    distTree[startVertex].weight = 0;
+    deletePQ(heap);
+    free(distances);
+    free(improved);
+    return distTree;
+}
@@ -0,0 +1,62 @@
+/*
+ * Vectorized edge relaxation over CSR adjacency arrays.
+ *
+ * A CSR vertex's targets and weights are contiguous, so its candidate
+ * distances can be formed, compared against the gathered distances of
+ * its neighbours, and filtered down to the edges that improve, 8 (AVX2)
+ * or 16 (AVX-512) edges at a time. Only those edges then take the
+ * scalar path that updates the distance tree and the priority queue.
+ * The kernel is picked at run time from what the CPU supports, with a
+ * scalar fallback on other CPUs and compilers.
+ */
+
+#ifndef RELAX_H
+#define RELAX_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "csr.h"
+
+typedef enum relaxKernel
+{
+  RELAX_AUTO,     // the widest kernel this CPU supports
+  RELAX_SCALAR,
+  RELAX_AVX2,
+  RELAX_AVX512
+} RelaxKernel;
+
+/*
+ * Returns true iff 'kernel' was compiled in and the CPU supports it.
+ * RELAX_AUTO and RELAX_SCALAR are always available.
+ */
+bool hasRelaxKernel(RelaxKernel kernel);
+
+/*
+ * Returns the kernel RELAX_AUTO stands for on this CPU.
+ */
+RelaxKernel getBestRelaxKernel(void);
+
+const char* relaxKernelName(RelaxKernel kernel);
+
+/*
+ * For the 'count' edges with 'targets' and 'weights' leaving a vertex at
+ * distance 'distance', stores in 'improved' the index (0..count-1) of
+ * every edge with distance + weight below distances[target], in order,
+ * and returns how many there are. Sums are taken as unsigned, so with
+ * non-negative distances and weights they never wrap. 'distances' is
+ * only read: with parallel edges several indices may name the same
+ * target, so the caller must compare again as it updates.
+ * Precondition: 'kernel' is available.
+ */
+int relaxCandidates(RelaxKernel kernel, const int* targets, const int* weights, int count,
+                    int distance, const int* distances, int* improved);
+
+/*
+ * Same as getDistanceTreeDijkstraCSR, relaxing the edges of vertices of
+ * degree 8 or more with relaxCandidates and 'kernel'. Edge weights must
+ * be non-negative. Returns NULL on invalid arguments, a negative weight,
+ * an unavailable kernel, or allocation failure.
+ */
+Edge* getDistanceTreeDijkstraVector(CSRGraph* csr, int startVertex, RelaxKernel kernel);
+
+#endif
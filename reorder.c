@@ -0,0 +1,418 @@
+/*
+ * Vertex reordering for memory locality.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "reorder.h"
+
+#define HILBERT_BITS 16  // per coordinate, so an index fits in 32 bits
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+/*
+ * Returns a new array of the out-degree of every vertex of 'graph', or
+ * NULL on allocation failure.
+ */
+static int* getOutDegrees(Graph* graph) {
+    int* degrees = (int*)malloc(graph->numVertices * sizeof(int));
+    if (degrees == NULL) {
+        return NULL;
+    }
+    for (int u = 0; u < graph->numVertices; u++) {
+        degrees[u] = 0;
+        for (EdgeList* adj = graph->vertices[u]->adjList; adj != NULL; adj = adj->next) {
+            degrees[u]++;
+        }
+    }
+    return degrees;
+}
+
+/*
+ * Returns a new array of the ids of 'graph' sorted by increasing (or,
+ * if 'descending', decreasing) 'degrees', ties by id: a counting sort,
+ * as degrees are below numEdges. Returns NULL on allocation failure.
+ */
+static int* sortByDegree(Graph* graph, int* degrees, bool descending) {
+    int n = graph->numVertices;
+    int maxDegree = 0;
+    for (int u = 0; u < n; u++) {
+        maxDegree = degrees[u] > maxDegree ? degrees[u] : maxDegree;
+    }
+    int* starts = (int*)calloc(maxDegree + 2, sizeof(int));
+    int* sorted = (int*)malloc(n * sizeof(int));
+    if (starts == NULL || sorted == NULL) {
+        free(starts);
+        free(sorted);
+        return NULL;
+    }
+    for (int u = 0; u < n; u++) {
+        int key = descending ? maxDegree - degrees[u] : degrees[u];
+        starts[key + 1]++;
+    }
+    for (int d = 0; d <= maxDegree; d++) {
+        starts[d + 1] += starts[d];
+    }
+    for (int u = 0; u < n; u++) {
+        int key = descending ? maxDegree - degrees[u] : degrees[u];
+        sorted[starts[key]++] = u;
+    }
+    free(starts);
+    return sorted;
+}
+
+static int compareKeys(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Appends the vertices reachable from 'root' and not yet 'visited' to
+ * 'order', which doubles as the queue, in breadth-first order. With
+ * 'degrees', the neighbours found from each vertex are appended by
+ * increasing degree (Cuthill–McKee), sorted through 'keys'. Returns the
+ * new length of 'order'.
+ */
+static int appendBreadthFirst(Graph* graph, int root, int* order, int count, bool* visited,
+                              int* degrees, uint64_t* keys) {
+    visited[root] = true;
+    order[count++] = root;
+    for (int head = count - 1; head < count; head++) {
+        int first = count;
+        for (EdgeList* adj = graph->vertices[order[head]]->adjList; adj != NULL; adj = adj->next) {
+            int v = adj->edge->toVertex;
+            if (!visited[v]) {
+                visited[v] = true;
+                order[count++] = v;
+            }
+        }
+        if (degrees != NULL && count - first > 1) {
+            for (int i = first; i < count; i++) {
+                keys[i - first] = (uint64_t)degrees[order[i]] << 32 | (uint32_t)order[i];
+            }
+            qsort(keys, count - first, sizeof(uint64_t), compareKeys);
+            for (int i = first; i < count; i++) {
+                order[i] = (int)(uint32_t)keys[i - first];
+            }
+        }
+    }
+    return count;
+}
+
+/*
+ * Returns the index along a Hilbert curve of 2^HILBERT_BITS cells a side
+ * of the cell (x, y).
+ */
+static uint32_t hilbertIndex(uint32_t x, uint32_t y) {
+    uint32_t index = 0;
+    for (uint32_t s = 1u << (HILBERT_BITS - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) != 0;
+        uint32_t ry = (y & s) != 0;
+        index += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so that the curve inside it starts and
+        // ends where the outer one needs it to
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            uint32_t t = x;
+            x = y;
+            y = t;
+        }
+    }
+    return index;
+}
+
+/*
+ * Returns a new array of the ids of 'graph' in Hilbert curve order of
+ * their Coordinates, scaled to the bounding box. Returns NULL if a
+ * vertex has no coordinates or on allocation failure.
+ */
+static int* getHilbertOrder(Graph* graph) {
+    int n = graph->numVertices;
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (int u = 0; u < n; u++) {
+        Coordinates* c = (Coordinates*)graph->vertices[u]->value;
+        if (c == NULL) {
+            return NULL;
+        }
+        if (u == 0 || c->x < minX) minX = c->x;
+        if (u == 0 || c->x > maxX) maxX = c->x;
+        if (u == 0 || c->y < minY) minY = c->y;
+        if (u == 0 || c->y > maxY) maxY = c->y;
+    }
+    uint64_t* keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    int* order = (int*)malloc(n * sizeof(int));
+    if (keys == NULL || order == NULL) {
+        free(keys);
+        free(order);
+        return NULL;
+    }
+    double cells = (double)((1u << HILBERT_BITS) - 1);
+    double scaleX = maxX > minX ? cells / (maxX - minX) : 0;
+    double scaleY = maxY > minY ? cells / (maxY - minY) : 0;
+    for (int u = 0; u < n; u++) {
+        Coordinates* c = (Coordinates*)graph->vertices[u]->value;
+        uint32_t x = (uint32_t)((c->x - minX) * scaleX);
+        uint32_t y = (uint32_t)((c->y - minY) * scaleY);
+        keys[u] = (uint64_t)hilbertIndex(x, y) << 32 | (uint32_t)u;
+    }
+    qsort(keys, n, sizeof(uint64_t), compareKeys);
+    for (int i = 0; i < n; i++) {
+        order[i] = (int)(uint32_t)keys[i];
+    }
+    free(keys);
+    return order;
+}
+
+/*************************************************************************
+ ** Orders and relabeling
+ *************************************************************************/
+
+int* getVertexOrder(Graph* graph, VertexOrder order) {
+    if (graph == NULL || graph->numVertices <= 0) {
+        return NULL;
+    }
+    if (order == ORDER_HILBERT) {
+        return getHilbertOrder(graph);
+    }
+    int n = graph->numVertices;
+    int* degrees = getOutDegrees(graph);
+    if (degrees == NULL) {
+        return NULL;
+    }
+    if (order == ORDER_DEGREE) {
+        int* sorted = sortByDegree(graph, degrees, true);
+        free(degrees);
+        return sorted;
+    }
+    int* result = (int*)malloc(n * sizeof(int));
+    bool* visited = (bool*)calloc(n, sizeof(bool));
+    int* roots = NULL;
+    uint64_t* keys = NULL;
+    if (order == ORDER_RCM) {
+        // components start from a vertex of least degree, a cheap
+        // stand-in for a peripheral one
+        roots = sortByDegree(graph, degrees, false);
+        keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    }
+    if (result == NULL || visited == NULL ||
+        (order == ORDER_RCM && (roots == NULL || keys == NULL))) {
+        free(degrees);
+        free(result);
+        free(visited);
+        free(roots);
+        free(keys);
+        return NULL;
+    }
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        int root = roots != NULL ? roots[i] : i;
+        if (!visited[root]) {
+            count = appendBreadthFirst(graph, root, result, count, visited,
+                                       order == ORDER_RCM ? degrees : NULL, keys);
+        }
+    }
+    if (order == ORDER_RCM) {
+        for (int i = 0, j = n - 1; i < j; i++, j--) {
+            int t = result[i];
+            result[i] = result[j];
+            result[j] = t;
+        }
+    }
+    free(degrees);
+    free(visited);
+    free(roots);
+    free(keys);
+    return result;
+}
+
+Graph* permuteGraph(Graph* graph, int* newIds, size_t payloadSize) {
+    if (graph == NULL || newIds == NULL) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    int* oldIds = (int*)malloc(n * sizeof(int));
+    if (oldIds == NULL) {
+        return NULL;
+    }
+    for (int u = 0; u < n; u++) {
+        oldIds[u] = -1;
+    }
+    for (int u = 0; u < n; u++) {
+        if (newIds[u] < 0 || newIds[u] >= n || oldIds[newIds[u]] != -1) {
+            free(oldIds);
+            return NULL;  // not a permutation
+        }
+        oldIds[newIds[u]] = u;
+    }
+    Graph* copy = newArenaGraph(n, 0);
+    if (copy == NULL) {
+        free(oldIds);
+        return NULL;
+    }
+    Arena* previous = setCurrentArena(copy->arena);
+    bool ok = true;
+    for (int u = 0; ok && u < n; u++) {
+        Vertex* from = graph->vertices[oldIds[u]];
+        // append rather than prepend to keep the adjList order
+        EdgeList** tail = &copy->vertices[u]->adjList;
+        for (EdgeList* adj = from->adjList; ok && adj != NULL; adj = adj->next) {
+            Edge* edge = newEdge(u, newIds[adj->edge->toVertex], adj->edge->weight);
+            EdgeList* node = edge != NULL ? newEdgeList(edge, NULL) : NULL;
+            ok = node != NULL;
+            if (ok) {
+                *tail = node;
+                tail = &node->next;
+            }
+        }
+        if (ok && payloadSize > 0 && from->value != NULL) {
+            copy->vertices[u]->value = arenaCalloc(1, payloadSize);
+            ok = copy->vertices[u]->value != NULL;
+            if (ok) {
+                memcpy(copy->vertices[u]->value, from->value, payloadSize);
+            }
+        }
+    }
+    setCurrentArena(previous);
+    free(oldIds);
+    if (!ok) {
+        deleteGraph(copy);
+        return NULL;
+    }
+    copy->numEdges = graph->numEdges;
+    return copy;
+}
+
+ReorderedGraph* reorderGraph(Graph* graph, VertexOrder order, size_t payloadSize) {
+    int* oldIds = getVertexOrder(graph, order);
+    if (oldIds == NULL) {
+        return NULL;
+    }
+    int n = graph->numVertices;
+    ReorderedGraph* reordered = (ReorderedGraph*)calloc(1, sizeof(ReorderedGraph));
+    int* newIds = (int*)malloc(n * sizeof(int));
+    if (reordered == NULL || newIds == NULL) {
+        free(reordered);
+        free(newIds);
+        free(oldIds);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        newIds[oldIds[i]] = i;
+    }
+    reordered->newIds = newIds;
+    reordered->oldIds = oldIds;
+    reordered->graph = permuteGraph(graph, newIds, payloadSize);
+    if (reordered->graph == NULL) {
+        deleteReorderedGraph(reordered);
+        return NULL;
+    }
+    return reordered;
+}
+
+void deleteReorderedGraph(ReorderedGraph* reordered) {
+    if (reordered != NULL) {
+        deleteGraph(reordered->graph);
+        free(reordered->newIds);
+        free(reordered->oldIds);
+        free(reordered);
+    }
+}
+
+/*************************************************************************
+ ** Searches in original ids
+ *************************************************************************/
+
+/*
+ * Returns true iff 'vertex' is a valid original id of 'reordered'.
+ */
+static bool isValidOriginal(ReorderedGraph* reordered, int vertex) {
+    return reordered != NULL && vertex >= 0 && vertex < reordered->graph->numVertices;
+}
+
+void translatePath(ReorderedGraph* reordered, EdgeList* path) {
+    for (; path != NULL; path = path->next) {
+        path->edge->fromVertex = reordered->oldIds[path->edge->fromVertex];
+        path->edge->toVertex = reordered->oldIds[path->edge->toVertex];
+    }
+}
+
+Edge* getDistanceTreeReordered(ReorderedGraph* reordered, int startVertex) {
+    if (!isValidOriginal(reordered, startVertex)) {
+        return NULL;
+    }
+    int n = reordered->graph->numVertices;
+    int start = reordered->newIds[startVertex];
+    Edge* inner = getDistanceTreeDijkstra(reordered->graph, start);
+    Edge* distTree = (Edge*)calloc(n, sizeof(Edge));
+    if (inner == NULL || distTree == NULL) {
+        free(inner);
+        free(distTree);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        // unreached entries are left zeroed, as getDistanceTreeDijkstra
+        // leaves them; a reached one names v and, unless v is the start,
+        // a predecessor other than v
+        Edge* entry = &inner[v];
+        if (entry->toVertex == v && (entry->fromVertex != v || v == start)) {
+            int old = reordered->oldIds[v];
+            distTree[old].fromVertex = reordered->oldIds[entry->fromVertex];
+            distTree[old].toVertex = old;
+            distTree[old].weight = entry->weight;
+        }
+    }
+    free(inner);
+    return distTree;
+}
+
+ShortestPathTree* getShortestPathTreeReordered(ReorderedGraph* reordered, int startVertex) {
+    if (!isValidOriginal(reordered, startVertex)) {
+        return NULL;
+    }
+    int n = reordered->graph->numVertices;
+    ShortestPathTree* inner = getShortestPathTree(reordered->graph,
+                                                  reordered->newIds[startVertex]);
+    ShortestPathTree* tree = (ShortestPathTree*)calloc(1, sizeof(ShortestPathTree));
+    if (inner == NULL || tree == NULL) {
+        deleteShortestPathTree(inner);
+        free(tree);
+        return NULL;
+    }
+    tree->numVertices = n;
+    tree->startVertex = startVertex;
+    tree->distances = (int*)malloc(n * sizeof(int));
+    tree->predecessors = (int*)malloc(n * sizeof(int));
+    tree->predWeights = (int*)malloc(n * sizeof(int));
+    if (tree->distances == NULL || tree->predecessors == NULL || tree->predWeights == NULL) {
+        deleteShortestPathTree(inner);
+        deleteShortestPathTree(tree);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        int old = reordered->oldIds[v];
+        int pred = inner->predecessors[v];
+        tree->distances[old] = inner->distances[v];
+        tree->predecessors[old] = pred == -1 ? -1 : reordered->oldIds[pred];
+        tree->predWeights[old] = inner->predWeights[v];
+    }
+    deleteShortestPathTree(inner);
+    return tree;
+}
+
+EdgeList* getShortestPathReordered(ReorderedGraph* reordered, int startVertex,
+                                   int targetVertex) {
+    if (!isValidOriginal(reordered, startVertex) || !isValidOriginal(reordered, targetVertex)) {
+        return NULL;
+    }
+    EdgeList* path = getShortestPath(reordered->graph, reordered->newIds[startVertex],
+                                     reordered->newIds[targetVertex]);
+    translatePath(reordered, path);
+    return path;
+}
@@ -0,0 +1,83 @@
+/*
+ * Vertex reordering for memory locality.
+ *
+ * Searches index distances, predecessors and the vertices array by
+ * vertex id, so ids that follow the input file scatter neighbours across
+ * memory. reorderGraph relabels a graph so that vertices close in the
+ * graph get close ids, and rebuilds it in an arena so that each vertex's
+ * adjacency nodes are also laid out in id order. The permutations map
+ * between the original and the new ids, and the *Reordered searches take
+ * and return original ids so that callers never see the new ones.
+ */
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <stddef.h>
+#include "graph.h"
+#include "graph_algos.h"
+
+typedef enum vertexOrder
+{
+  ORDER_BFS,      // breadth-first from vertex 0, then from each vertex
+                  //   not yet reached, in id order
+  ORDER_RCM,      // reverse Cuthill–McKee: breadth-first from a vertex of
+                  //   least degree per component, neighbours by
+                  //   increasing degree, then reversed
+  ORDER_DEGREE,   // by decreasing out-degree, so that hubs share lines
+  ORDER_HILBERT   // along a Hilbert curve through the vertex
+                  //   Coordinates; every vertex value must be one
+} VertexOrder;
+
+typedef struct reorderedGraph
+{
+  Graph* graph;   // the relabeled graph, backed by its own arena
+  int* newIds;    // newIds[old id] is the id of that vertex in 'graph'
+  int* oldIds;    // oldIds[new id] is its original id; the inverse
+} ReorderedGraph;
+
+/*
+ * Returns the order 'order' of the vertices of 'graph' as a new array
+ * of their ids, first vertex first (i.e. the oldIds permutation).
+ * Edge directions are followed as stored, so undirected graphs should
+ * hold both directions. Returns NULL on invalid arguments, if
+ * ORDER_HILBERT meets a vertex without coordinates, or on allocation
+ * failure.
+ */
+int* getVertexOrder(Graph* graph, VertexOrder order);
+
+/*
+ * Returns a copy of 'graph' in which vertex u becomes vertex newIds[u],
+ * 'newIds' being a permutation of 0..numVertices-1. The copy is an arena
+ * graph whose vertices, adjacency nodes and edges are allocated in new
+ * id order and keep their adjList order. Vertex values are copied as
+ * 'payloadSize' bytes each (NULL values stay NULL), or left NULL if
+ * 'payloadSize' is 0. Returns NULL on invalid arguments or allocation
+ * failure.
+ */
+Graph* permuteGraph(Graph* graph, int* newIds, size_t payloadSize);
+
+/*
+ * getVertexOrder and permuteGraph in one. Returns NULL on failure.
+ */
+ReorderedGraph* reorderGraph(Graph* graph, VertexOrder order, size_t payloadSize);
+void deleteReorderedGraph(ReorderedGraph* reordered);
+
+/*
+ * Renames the vertices of every edge of 'path', which comes from a search
+ * on reordered->graph, back to original ids in place.
+ */
+void translatePath(ReorderedGraph* reordered, EdgeList* path);
+
+/*
+ * Same as getDistanceTreeDijkstra, getShortestPathTree and
+ * getShortestPath on the original graph, but searching
+ * reordered->graph: vertex ids in and out are original ids, and the
+ * returned arrays are indexed by original id.
+ */
+Edge* getDistanceTreeReordered(ReorderedGraph* reordered, int startVertex);
+ShortestPathTree* getShortestPathTreeReordered(ReorderedGraph* reordered, int startVertex);
+EdgeList* getShortestPathReordered(ReorderedGraph* reordered, int startVertex,
+                                   int targetVertex);
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * Specialized searches with the interface of the generic ones.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include "search.h"
+#include "search_engine.h"
+#include "graph_algos.h"
+
+/*
+ * Visitor of searchShortestPathEuclidean: stops at the target and
+ * estimates scale * euclideanDistance to it, as euclideanHeuristic.
+ */
+typedef struct euclideanTarget
+{
+  Graph* graph;
+  int targetVertex;
+  Coordinates* to;  // coordinates of targetVertex, or NULL
+  double scale;
+} EuclideanTarget;
+
+static inline bool euclideanSettle(void* data, int u) {
+    return u == ((EuclideanTarget*)data)->targetVertex;
+}
+
+static inline int euclideanEstimate(void* data, int v) {
+    EuclideanTarget* target = (EuclideanTarget*)data;
+    Coordinates* from = (Coordinates*)target->graph->vertices[v]->value;
+    if (from == NULL || target->to == NULL) {
+        return 0;
+    }
+    double dx = from->x - target->to->x;
+    double dy = from->y - target->to->y;
+    double estimate = target->scale * sqrt(dx * dx + dy * dy);
+    return estimate >= INT_MAX ? INT_MAX - 1 : (int)estimate;
+}
+
+DEFINE_SEARCH_ENGINE(LinkedTree, LINKED, int, INT_MAX, addDistance, DARY, searchAll)
+DEFINE_SEARCH_ENGINE(CSRTree, CSR, int, INT_MAX, addDistance, DARY, searchAll)
+DEFINE_SEARCH_ENGINE(LinkedPrim, LINKED, int, INT_MAX, SEARCH_KEY_EDGE, DARY, searchAll)
+DEFINE_SEARCH_ENGINE(CSRPrim, CSR, int, INT_MAX, SEARCH_KEY_EDGE, DARY, searchAll)
+DEFINE_SEARCH_ENGINE(LinkedTree64, LINKED, int64_t, DISTANCE64_INFINITY, SEARCH_ADD_INT64,
+                     DARY, searchAll)
+DEFINE_SEARCH_ENGINE(LinkedPath, LINKED, int, INT_MAX, addDistance, LAZY, searchTarget)
+DEFINE_SEARCH_ENGINE(LinkedAStar, LINKED, int, INT_MAX, addDistance, LAZY, euclidean)
+DEFINE_SEARCH_ENGINE(LinkedTargets, LINKED, int, INT_MAX, addDistance, DARY,
+                     searchTargetSet)
+
+/*************************************************************************
+ ** Helper functions
+ *************************************************************************/
+
+/*
+ * Returns a distance tree laid out as getDistanceTreeDijkstra's from
+ * the predecessors and keys of a search from 'startVertex'.
+ */
+static Edge* makeDistanceTree(int numVertices, int* predecessors, int* keys, int startVertex) {
+    Edge* distTree = (Edge*)calloc(numVertices, sizeof(Edge));
+    if (distTree == NULL) {
+        return NULL;
+    }
+    for (int v = 0; v < numVertices; v++) {
+        if (predecessors[v] != -1) {
+            distTree[v].fromVertex = predecessors[v];
+            distTree[v].toVertex = v;
+            distTree[v].weight = keys[v];
+        }
+    }
+    distTree[startVertex].fromVertex = startVertex;
+    distTree[startVertex].toVertex = startVertex;
+    return distTree;
+}
+
+/*
+ * Returns an MST array laid out as getMSTprim's: the edge from each
+ * vertex settled after 'order[0]' to its predecessor, in settling order.
+ */
+static Edge* makeSpanningTree(int numVertices, int* order, int numSettled,
+                              int* predecessors, int* keys) {
+    Edge* tree = (Edge*)calloc(numVertices, sizeof(Edge));
+    if (tree == NULL) {
+        return NULL;
+    }
+    for (int i = 1; i < numSettled; i++) {
+        int v = order[i];
+        tree[i - 1].fromVertex = v;
+        tree[i - 1].toVertex = predecessors[v];
+        tree[i - 1].weight = keys[v];
+    }
+    return tree;
+}
+
+/*************************************************************************
+ ** Public interface
+ *************************************************************************/
+
+Edge* searchDistanceTree(Graph* graph, int startVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {
+        return NULL;
+    }
+    LinkedTreeSearch search;
+    if (!LinkedTreeInit(&search, graph->numVertices)) {
+        return NULL;
+    }
+    Edge* distTree = NULL;
+    if (LinkedTreeRun(&search, graph, startVertex, NULL) != -1) {
+        distTree = makeDistanceTree(graph->numVertices, search.predecessors, search.keys,
+                                    startVertex);
+    }
+    LinkedTreeFree(&search);
+    return distTree;
+}
+
+Edge* searchDistanceTreeCSR(CSRGraph* csr, int startVertex) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices) {
+        return NULL;
+    }
+    CSRTreeSearch search;
+    if (!CSRTreeInit(&search, csr->numVertices)) {
+        return NULL;
+    }
+    Edge* distTree = NULL;
+    if (CSRTreeRun(&search, csr, startVertex, NULL) != -1) {
+        distTree = makeDistanceTree(csr->numVertices, search.predecessors, search.keys,
+                                    startVertex);
+    }
+    CSRTreeFree(&search);
+    return distTree;
+}
+
+Edge* searchMSTprim(Graph* graph, int startVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {
+        return NULL;
+    }
+    LinkedPrimSearch search;
+    if (!LinkedPrimInit(&search, graph->numVertices)) {
+        return NULL;
+    }
+    Edge* tree = NULL;
+    int numSettled = LinkedPrimRun(&search, graph, startVertex, NULL);
+    if (numSettled != -1) {
+        tree = makeSpanningTree(graph->numVertices, search.order, numSettled,
+                                search.predecessors, search.keys);
+    }
+    LinkedPrimFree(&search);
+    return tree;
+}
+
+Edge* searchMSTprimCSR(CSRGraph* csr, int startVertex) {
+    if (csr == NULL || startVertex < 0 || startVertex >= csr->numVertices) {
+        return NULL;
+    }
+    CSRPrimSearch search;
+    if (!CSRPrimInit(&search, csr->numVertices)) {
+        return NULL;
+    }
+    Edge* tree = NULL;
+    int numSettled = CSRPrimRun(&search, csr, startVertex, NULL);
+    if (numSettled != -1) {
+        tree = makeSpanningTree(csr->numVertices, search.order, numSettled,
+                                search.predecessors, search.keys);
+    }
+    CSRPrimFree(&search);
+    return tree;
+}
+
+DistanceTree64* searchDistanceTree64(Graph* graph, int startVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices) {
+        return NULL;
+    }
+    DistanceTree64* tree = (DistanceTree64*)calloc(1, sizeof(DistanceTree64));
+    LinkedTree64Search search;
+    if (tree == NULL || !LinkedTree64Init(&search, graph->numVertices)) {
+        free(tree);
+        return NULL;
+    }
+    if (LinkedTree64Run(&search, graph, startVertex, NULL) == -1) {
+        LinkedTree64Free(&search);
+        free(tree);
+        return NULL;
+    }
+    // the tree takes over the arrays it shares with the search
+    tree->numVertices = graph->numVertices;
+    tree->startVertex = startVertex;
+    tree->distances = search.keys;
+    tree->predecessors = search.predecessors;
+    search.keys = NULL;
+    search.predecessors = NULL;
+    LinkedTree64Free(&search);
+    return tree;
+}
+
+EdgeList* searchShortestPath(Graph* graph, int startVertex, int targetVertex) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    LinkedPathSearch search;
+    if (!LinkedPathInit(&search, graph->numVertices)) {
+        return NULL;
+    }
+    EdgeList* path = NULL;
+    if (LinkedPathRun(&search, graph, startVertex, &targetVertex) != -1 &&
+        search.finished[targetVertex]) {
+        path = makePathFromPredecessors(search.predecessors, search.predWeights,
+                                        targetVertex, startVertex);
+    }
+    LinkedPathFree(&search);
+    return path;
+}
+
+EdgeList* searchShortestPathEuclidean(Graph* graph, int startVertex, int targetVertex,
+                                      double scale, int* numSettled) {
+    if (numSettled != NULL) {
+        *numSettled = 0;
+    }
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targetVertex < 0 || targetVertex >= graph->numVertices ||
+        startVertex == targetVertex) {
+        return NULL;
+    }
+    LinkedAStarSearch search;
+    if (!LinkedAStarInit(&search, graph->numVertices)) {
+        return NULL;
+    }
+    EuclideanTarget target;
+    target.graph = graph;
+    target.targetVertex = targetVertex;
+    target.to = (Coordinates*)graph->vertices[targetVertex]->value;
+    target.scale = scale;
+    EdgeList* path = NULL;
+    int settled = LinkedAStarRun(&search, graph, startVertex, &target);
+    if (settled != -1 && search.finished[targetVertex]) {
+        path = makePathFromPredecessors(search.predecessors, search.predWeights,
+                                        targetVertex, startVertex);
+    }
+    if (numSettled != NULL && settled != -1) {
+        *numSettled = settled;
+    }
+    LinkedAStarFree(&search);
+    return path;
+}
+
+bool searchTargetDistances(Graph* graph, int startVertex, const int* targets,
+                           int numTargets, int* distances) {
+    if (graph == NULL || startVertex < 0 || startVertex >= graph->numVertices ||
+        targets == NULL || numTargets < 0 || distances == NULL) {
+        return false;
+    }
+    int n = graph->numVertices;
+    for (int i = 0; i < numTargets; i++) {
+        if (targets[i] < 0 || targets[i] >= n) {
+            return false;
+        }
+    }
+    if (numTargets == 0) {
+        return true;
+    }
+    bool* isTarget = (bool*)calloc(n, sizeof(bool));
+    LinkedTargetsSearch search;
+    if (isTarget == NULL || !LinkedTargetsInit(&search, n)) {
+        free(isTarget);
+        return false;
+    }
+    SearchTargetSet targetSet;
+    targetSet.isTarget = isTarget;
+    targetSet.remaining = 0;
+    for (int i = 0; i < numTargets; i++) {
+        if (!isTarget[targets[i]]) {
+            isTarget[targets[i]] = true;
+            targetSet.remaining++;
+        }
+    }
+    // targets left unsettled are unreachable, at INT_MAX
+    bool done = LinkedTargetsRun(&search, graph, startVertex, &targetSet) != -1;
+    for (int i = 0; done && i < numTargets; i++) {
+        distances[i] = search.keys[targets[i]];
+    }
+    free(isTarget);
+    LinkedTargetsFree(&search);
+    return done;
+}
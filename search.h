@@ -0,0 +1,60 @@
+/*
+ * Specialized searches with the interface of the generic ones.
+ *
+ * Each function is a search_engine.h instantiation behind the signature
+ * and result layout of its counterpart in graph_algos.c, csr.c or
+ * distance.c, so a caller can switch to it without other changes. The
+ * generic functions stay for what these do not fix at compile time: a
+ * PQ backend picked at run time, stats of the PriorityQueue calls and
+ * arbitrary Heuristic callbacks.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h>
+#include "graph.h"
+#include "csr.h"
+#include "distance.h"
+
+/*
+ * Same as getDistanceTreeDijkstra, getDistanceTreeDijkstraCSR,
+ * getMSTprim and getMSTprimCSR. The MST arrays hold numVertices edges,
+ * the first numVertices - 1 of them the tree in the order Prim's
+ * algorithm adds them. On a disconnected graph only the component of
+ * 'startVertex' is spanned, as by getMSTprimPQ with any kind other than
+ * PQ_BINARY_HEAP; see getMinimumSpanningForest for the rest.
+ */
+Edge* searchDistanceTree(Graph* graph, int startVertex);
+Edge* searchDistanceTreeCSR(CSRGraph* csr, int startVertex);
+Edge* searchMSTprim(Graph* graph, int startVertex);
+Edge* searchMSTprimCSR(CSRGraph* csr, int startVertex);
+
+/*
+ * Same as getDistanceTree64.
+ */
+DistanceTree64* searchDistanceTree64(Graph* graph, int startVertex);
+
+/*
+ * Same as getShortestPath, stopping as soon as 'targetVertex' is
+ * settled.
+ */
+EdgeList* searchShortestPath(Graph* graph, int startVertex, int targetVertex);
+
+/*
+ * Same as getShortestPathAStar with euclideanHeuristic and 'scale', the
+ * heuristic compiled into the search instead of called through a
+ * pointer.
+ */
+EdgeList* searchShortestPathEuclidean(Graph* graph, int startVertex, int targetVertex,
+                                      double scale, int* numSettled);
+
+/*
+ * Stores in distances[i] the distance from 'startVertex' to targets[i],
+ * INT_MAX if it is unreachable, stopping once every target is settled.
+ * Returns false on invalid arguments or allocation failure.
+ */
+bool searchTargetDistances(Graph* graph, int startVertex, const int* targets,
+                           int numTargets, int* distances);
+
+#endif
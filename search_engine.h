@@ -0,0 +1,248 @@
+/*
+ * Compile-time specialized search kernels.
+ *
+ * The searches of graph_algos.c are written once against the linked
+ * Graph, int distances and a PriorityQueue picked at run time, so every
+ * step goes through a backend switch and out-of-line heap calls. The
+ * macros here stamp out a search with every such choice fixed when it
+ * is compiled, in the way distance.c instantiates its distance types:
+ *
+ *   DEFINE_SEARCH_ENGINE(Name, LAYOUT, Type, INFINITY_VALUE, KEY, QUEUE, Visitor)
+ *
+ * LAYOUT is LINKED (Graph) or CSR (CSRGraph); Type is the distance type,
+ * INFINITY_VALUE its unreachable value; KEY(distance, weight) is the key
+ * a vertex is reached with over an edge: addDistance, SEARCH_ADD_INT64
+ * or SEARCH_ADD_DOUBLE for Dijkstra and A*, SEARCH_KEY_EDGE for Prim.
+ * QUEUE is DARY, an indexed 4-ary heap with decrease-key, or LAZY, a
+ * binary heap that pushes a vertex again whenever its key drops; both
+ * come from search_queue.h. Visitor is the prefix of two functions, which
+ * must be visible where the engine is defined:
+ *
+ *   bool Visitor##Settle(void* data, int u)    true ends the search once
+ *                                              u is settled
+ *   int Visitor##Estimate(void* data, int v)   lower bound on the distance
+ *                                              from v to the target, or 0
+ *
+ * A* is Dijkstra with a visitor whose estimate is not 0. Everything is
+ * static inline, so the queue, the edge loop and the hooks are compiled
+ * into one function per instantiation; define engines in a .c file.
+ * The generated interface is
+ *
+ *   bool Name##Init(Name##Search* search, int numVertices)
+ *   void Name##Free(Name##Search* search)
+ *   int Name##Run(Name##Search* search, graph, int startVertex, void* data)
+ *
+ * Run returns the number of vertices settled, or -1 on allocation
+ * failure, and leaves in 'search' the keys, predecessors (-1 for the
+ * start and unreached vertices), predecessor edge weights and the order
+ * in which vertices were settled. A search
+ * can be run again from another vertex without a new Init.
+ */
+
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "graph.h"
+#include "csr.h"
+#include "search_queue.h"
+#include "stats.h"
+
+/****
+ ** Keys
+ ****/
+
+/*
+ * Prim's key: the weight of the edge alone. The saturating additions
+ * for Dijkstra and A* are addDistance (graph.h) for int distances and
+ * SEARCH_ADD_INT64 and SEARCH_ADD_DOUBLE (search_queue.h).
+ */
+#define SEARCH_KEY_EDGE(distance, weight) ((void)(distance), (weight))
+
+/*
+ * The queue priority of a vertex reached with 'key' and estimated to be
+ * 'estimate' from the target, saturating at 'infinity'. An estimate that
+ * is always 0 compiles away.
+ */
+#define SEARCH_PRIORITY(key, estimate, infinity)                              \
+    ((estimate) == 0 ? (key)                                                  \
+                     : (key) >= (infinity) - (estimate) ? (infinity) : (key) + (estimate))
+
+/****
+ ** Layouts
+ ****/
+
+/*
+ * Each layout names its graph type and walks the out-edges of u with a
+ * cursor: FIRST(graph, u) starts it, VALID(graph, u, cursor) is false
+ * past the last edge, and TARGET and WEIGHT read the edge under it.
+ */
+#define SEARCH_LINKED_GRAPH Graph
+#define SEARCH_LINKED_CURSOR EdgeList*
+#define SEARCH_LINKED_FIRST(graph, u) ((graph)->vertices[u]->adjList)
+#define SEARCH_LINKED_VALID(graph, u, cursor) ((cursor) != NULL)
+#define SEARCH_LINKED_NEXT(graph, cursor) ((cursor) = (cursor)->next)
+#define SEARCH_LINKED_TARGET(graph, cursor) ((cursor)->edge->toVertex)
+#define SEARCH_LINKED_WEIGHT(graph, cursor) ((cursor)->edge->weight)
+
+#define SEARCH_CSR_GRAPH CSRGraph
+#define SEARCH_CSR_CURSOR int
+#define SEARCH_CSR_FIRST(graph, u) ((graph)->offsets[u])
+#define SEARCH_CSR_VALID(graph, u, cursor) ((cursor) < (graph)->offsets[(u) + 1])
+#define SEARCH_CSR_NEXT(graph, cursor) ((cursor)++)
+#define SEARCH_CSR_TARGET(graph, cursor) ((graph)->targets[cursor])
+#define SEARCH_CSR_WEIGHT(graph, cursor) ((graph)->weights[cursor])
+
+/****
+ ** Visitors
+ ****/
+
+/*
+ * searchAll runs to completion. searchTarget stops at the vertex 'data'
+ * points to. searchTargetSet stops once every marked vertex of the
+ * SearchTargetSet in 'data' is settled.
+ */
+typedef struct searchTargetSet
+{
+  const bool* isTarget;  // isTarget[id] is true iff id is a target
+  int remaining;         // targets not settled yet
+} SearchTargetSet;
+
+static inline bool searchAllSettle(void* data, int u) {
+    (void)data;
+    (void)u;
+    return false;
+}
+
+static inline int searchAllEstimate(void* data, int v) {
+    (void)data;
+    (void)v;
+    return 0;
+}
+
+static inline bool searchTargetSettle(void* data, int u) {
+    return u == *(int*)data;
+}
+
+static inline int searchTargetEstimate(void* data, int v) {
+    (void)data;
+    (void)v;
+    return 0;
+}
+
+static inline bool searchTargetSetSettle(void* data, int u) {
+    SearchTargetSet* targets = (SearchTargetSet*)data;
+    return targets->isTarget[u] && --targets->remaining == 0;
+}
+
+static inline int searchTargetSetEstimate(void* data, int v) {
+    (void)data;
+    (void)v;
+    return 0;
+}
+
+/****
+ ** Engine
+ ****/
+
+#define DEFINE_SEARCH_ENGINE(Name, LAYOUT, Type, INFINITY_VALUE, KEY, QUEUE, Visitor)  \
+                                                                                      \
+DEFINE_SEARCH_QUEUE_##QUEUE(Name##Queue, Type)                                        \
+                                                                                      \
+typedef struct Name##Search                                                           \
+{                                                                                     \
+  int numVertices;                                                                    \
+  Type* keys;         /* keys[id] is the best key id was reached with */             \
+  int* predecessors;  /* predecessors[id] is the vertex it was reached from */       \
+  int* predWeights;   /* predWeights[id] is the weight of that edge */               \
+  bool* finished;     /* finished[id] is true iff id is settled */                   \
+  int* order;         /* order[i] is the i-th vertex settled */                      \
+  Name##Queue queue;                                                                  \
+} Name##Search;                                                                       \
+                                                                                      \
+static inline void Name##Free(Name##Search* search) {                                 \
+    free(search->keys);                                                               \
+    free(search->predecessors);                                                       \
+    free(search->predWeights);                                                        \
+    free(search->finished);                                                           \
+    free(search->order);                                                              \
+    Name##QueueFree(&search->queue);                                                  \
+}                                                                                     \
+                                                                                      \
+static inline bool Name##Init(Name##Search* search, int numVertices) {                \
+    search->numVertices = numVertices;                                                \
+    search->keys = (Type*)malloc(numVertices * sizeof(Type));                         \
+    search->predecessors = (int*)malloc(numVertices * sizeof(int));                   \
+    search->predWeights = (int*)malloc(numVertices * sizeof(int));                    \
+    search->finished = (bool*)malloc(numVertices * sizeof(bool));                     \
+    search->order = (int*)malloc(numVertices * sizeof(int));                          \
+    bool queued = Name##QueueInit(&search->queue, numVertices);                       \
+    if (!queued || search->keys == NULL || search->predecessors == NULL ||            \
+        search->predWeights == NULL || search->finished == NULL ||                    \
+        search->order == NULL) {                                                      \
+        if (queued) {                                                                 \
+            Name##QueueFree(&search->queue);                                          \
+        }                                                                             \
+        free(search->keys);                                                           \
+        free(search->predecessors);                                                   \
+        free(search->predWeights);                                                    \
+        free(search->finished);                                                       \
+        free(search->order);                                                          \
+        return false;                                                                 \
+    }                                                                                 \
+    return true;                                                                      \
+}                                                                                     \
+                                                                                      \
+static inline int Name##Run(Name##Search* search, SEARCH_##LAYOUT##_GRAPH* graph,     \
+                            int startVertex, void* data) {                            \
+    for (int i = 0; i < search->numVertices; i++) {                                   \
+        search->keys[i] = INFINITY_VALUE;                                             \
+        search->predecessors[i] = -1;                                                 \
+        search->finished[i] = false;                                                  \
+    }                                                                                 \
+    /* an early exit leaves the queue non-empty */                                   \
+    Name##QueueClear(&search->queue);                                                 \
+    search->keys[startVertex] = 0;                                                    \
+    if (!Name##QueuePush(&search->queue, (Type)Visitor##Estimate(data, startVertex),  \
+                         startVertex)) {                                              \
+        return -1;                                                                    \
+    }                                                                                 \
+    int numSettled = 0;                                                               \
+    while (!Name##QueueIsEmpty(&search->queue)) {                                     \
+        Type ignored;                                                                 \
+        int u = Name##QueuePop(&search->queue, &ignored);                             \
+        if (search->finished[u]) {                                                    \
+            continue; /* stale entry of the lazy queue */                            \
+        }                                                                             \
+        search->finished[u] = true;                                                   \
+        search->order[numSettled++] = u;                                              \
+        if (Visitor##Settle(data, u)) {                                               \
+            break;                                                                    \
+        }                                                                             \
+        Type distance = search->keys[u];                                              \
+        for (SEARCH_##LAYOUT##_CURSOR cursor = SEARCH_##LAYOUT##_FIRST(graph, u);     \
+             SEARCH_##LAYOUT##_VALID(graph, u, cursor);                               \
+             SEARCH_##LAYOUT##_NEXT(graph, cursor)) {                                 \
+            int v = SEARCH_##LAYOUT##_TARGET(graph, cursor);                          \
+            int weight = SEARCH_##LAYOUT##_WEIGHT(graph, cursor);                     \
+            Type key = KEY(distance, (Type)weight);                                   \
+            STATS_COUNT(edgesScanned, 1);                                             \
+            if (!search->finished[v] && key < search->keys[v]) {                      \
+                STATS_COUNT(relaxations, 1);                                          \
+                search->keys[v] = key;                                                \
+                search->predecessors[v] = u;                                          \
+                search->predWeights[v] = weight;                                      \
+                Type estimate = (Type)Visitor##Estimate(data, v);                     \
+                Type priority = SEARCH_PRIORITY(key, estimate, INFINITY_VALUE);       \
+                if (!Name##QueuePush(&search->queue, priority, v)) {                  \
+                    return -1;                                                        \
+                }                                                                     \
+            }                                                                         \
+        }                                                                             \
+    }                                                                                 \
+    return numSettled;                                                                \
+}
+
+#endif
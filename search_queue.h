@@ -0,0 +1,233 @@
+/*
+ * Queues and saturating additions shared by the searches that fix their
+ * distance type when they are compiled: the search_engine.h kernels,
+ * the distance.c trees, the int64_t searches of ch.c and graph_algos.c,
+ * and the lazy backend of pq.c.
+ *
+ *   DEFINE_SEARCH_QUEUE_DARY(Queue, Type)
+ *   DEFINE_SEARCH_QUEUE_LAZY(Queue, Type)
+ *
+ * define a queue type 'Queue' with keys of type 'Type' and static inline
+ * functions prefixed with 'Queue'.
+ */
+
+#ifndef SEARCH_QUEUE_H
+#define SEARCH_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "stats.h"
+
+/****
+ ** Keys
+ ****/
+
+/*
+ * Saturating additions of a non-negative weight to a distance: a sum
+ * that would reach the infinity of its type is the infinity, so a path
+ * through an unreached vertex never lowers a distance. int distances
+ * use addDistance from graph.h.
+ */
+#define SEARCH_ADD_INT64(distance, weight) \
+    ((weight) >= INT64_MAX - (distance) ? INT64_MAX : (distance) + (weight))
+#define SEARCH_ADD_DOUBLE(distance, weight) ((distance) + (weight))
+
+/****
+ ** Queues
+ ****/
+
+/*
+ * Both queues have the same interface: Init(queue, numVertices),
+ * Free(queue), Clear(queue), IsEmpty(queue), Push(queue, key, id),
+ * which inserts id or lowers its key and returns false on allocation
+ * failure, and Pop(queue, &key), which returns the id of a minimum
+ * entry. Sifts move a hole instead of swapping at every level.
+ */
+#define DEFINE_SEARCH_QUEUE_DARY(Queue, Type)                                          \
+                                                                                      \
+typedef struct Queue##Entry                                                           \
+{                                                                                     \
+  Type key;                                                                           \
+  int id;                                                                             \
+} Queue##Entry;                                                                       \
+                                                                                      \
+typedef struct Queue                                                                  \
+{                                                                                     \
+  Queue##Entry* entries;                                                              \
+  int* positions;  /* positions[id] is the index of id in entries, or -1 */          \
+  int size;                                                                           \
+} Queue;                                                                              \
+                                                                                      \
+static inline void Queue##Free(Queue* queue) {                                        \
+    free(queue->entries);                                                             \
+    free(queue->positions);                                                           \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##Init(Queue* queue, int numVertices) {                       \
+    queue->size = 0;                                                                  \
+    queue->entries = (Queue##Entry*)malloc(numVertices * sizeof(Queue##Entry));       \
+    queue->positions = (int*)malloc(numVertices * sizeof(int));                       \
+    if (queue->entries == NULL || queue->positions == NULL) {                         \
+        Queue##Free(queue);                                                           \
+        return false;                                                                 \
+    }                                                                                 \
+    for (int i = 0; i < numVertices; i++) {                                           \
+        queue->positions[i] = -1;                                                     \
+    }                                                                                 \
+    return true;                                                                      \
+}                                                                                     \
+                                                                                      \
+static inline void Queue##Clear(Queue* queue) {                                       \
+    for (int i = 0; i < queue->size; i++) {                                           \
+        queue->positions[queue->entries[i].id] = -1;                                  \
+    }                                                                                 \
+    queue->size = 0;                                                                  \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##IsEmpty(Queue* queue) {                                     \
+    return queue->size == 0;                                                          \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##Push(Queue* queue, Type key, int id) {                      \
+    int hole = queue->positions[id];                                                  \
+    if (hole == -1) {                                                                 \
+        hole = queue->size++;                                                         \
+        STATS_COUNT(heapPushes, 1);                                                   \
+    } else {                                                                          \
+        STATS_COUNT(heapDecreases, 1);                                                \
+    }                                                                                 \
+    while (hole > 0 && queue->entries[(hole - 1) / 4].key > key) {                    \
+        int parent = (hole - 1) / 4;                                                  \
+        queue->entries[hole] = queue->entries[parent];                                \
+        queue->positions[queue->entries[hole].id] = hole;                             \
+        hole = parent;                                                                \
+        STATS_COUNT(heapSiftLevels, 1);                                               \
+    }                                                                                 \
+    queue->entries[hole].key = key;                                                   \
+    queue->entries[hole].id = id;                                                     \
+    queue->positions[id] = hole;                                                      \
+    return true;                                                                      \
+}                                                                                     \
+                                                                                      \
+static inline int Queue##Pop(Queue* queue, Type* key) {                               \
+    Queue##Entry top = queue->entries[0];                                             \
+    Queue##Entry last = queue->entries[--queue->size];                                \
+    queue->positions[top.id] = -1;                                                    \
+    STATS_COUNT(heapPops, 1);                                                         \
+    int size = queue->size;                                                           \
+    if (size > 0) {                                                                   \
+        int hole = 0;                                                                 \
+        for (;;) {                                                                    \
+            int first = 4 * hole + 1;                                                 \
+            if (first >= size) {                                                      \
+                break;                                                                \
+            }                                                                         \
+            int end = first + 4 < size ? first + 4 : size;                            \
+            int child = first;                                                        \
+            for (int c = first + 1; c < end; c++) {                                   \
+                if (queue->entries[c].key < queue->entries[child].key) {              \
+                    child = c;                                                        \
+                }                                                                     \
+            }                                                                         \
+            if (queue->entries[child].key >= last.key) {                              \
+                break;                                                                \
+            }                                                                         \
+            queue->entries[hole] = queue->entries[child];                             \
+            queue->positions[queue->entries[hole].id] = hole;                         \
+            hole = child;                                                             \
+            STATS_COUNT(heapSiftLevels, 1);                                           \
+        }                                                                             \
+        queue->entries[hole] = last;                                                  \
+        queue->positions[last.id] = hole;                                             \
+    }                                                                                 \
+    *key = top.key;                                                                   \
+    return top.id;                                                                    \
+}
+
+#define DEFINE_SEARCH_QUEUE_LAZY(Queue, Type)                                          \
+                                                                                      \
+typedef struct Queue##Entry                                                           \
+{                                                                                     \
+  Type key;                                                                           \
+  int id;                                                                             \
+} Queue##Entry;                                                                       \
+                                                                                      \
+typedef struct Queue                                                                  \
+{                                                                                     \
+  Queue##Entry* entries;                                                              \
+  int size;                                                                           \
+  int capacity;                                                                       \
+} Queue;                                                                              \
+                                                                                      \
+static inline void Queue##Free(Queue* queue) {                                        \
+    free(queue->entries);                                                             \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##Init(Queue* queue, int numVertices) {                       \
+    queue->size = 0;                                                                  \
+    queue->capacity = numVertices > 64 ? numVertices : 64;                            \
+    queue->entries = (Queue##Entry*)malloc(queue->capacity * sizeof(Queue##Entry));   \
+    return queue->entries != NULL;                                                    \
+}                                                                                     \
+                                                                                      \
+static inline void Queue##Clear(Queue* queue) {                                       \
+    queue->size = 0;                                                                  \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##IsEmpty(Queue* queue) {                                     \
+    return queue->size == 0;                                                          \
+}                                                                                     \
+                                                                                      \
+static inline bool Queue##Push(Queue* queue, Type key, int id) {                      \
+    if (queue->size == queue->capacity) {                                             \
+        Queue##Entry* grown = (Queue##Entry*)realloc(queue->entries,                  \
+            2 * queue->capacity * sizeof(Queue##Entry));                              \
+        if (grown == NULL) {                                                          \
+            return false;                                                             \
+        }                                                                             \
+        queue->entries = grown;                                                       \
+        queue->capacity *= 2;                                                         \
+    }                                                                                 \
+    int hole = queue->size++;                                                         \
+    STATS_COUNT(heapPushes, 1);                                                       \
+    while (hole > 0 && queue->entries[(hole - 1) / 2].key > key) {                    \
+        queue->entries[hole] = queue->entries[(hole - 1) / 2];                        \
+        hole = (hole - 1) / 2;                                                        \
+        STATS_COUNT(heapSiftLevels, 1);                                               \
+    }                                                                                 \
+    queue->entries[hole].key = key;                                                   \
+    queue->entries[hole].id = id;                                                     \
+    return true;                                                                      \
+}                                                                                     \
+                                                                                      \
+static inline int Queue##Pop(Queue* queue, Type* key) {                               \
+    Queue##Entry top = queue->entries[0];                                             \
+    Queue##Entry last = queue->entries[--queue->size];                                \
+    STATS_COUNT(heapPops, 1);                                                         \
+    int size = queue->size;                                                           \
+    if (size > 0) {                                                                   \
+        int hole = 0;                                                                 \
+        for (;;) {                                                                    \
+            int child = 2 * hole + 1;                                                 \
+            if (child >= size) {                                                      \
+                break;                                                                \
+            }                                                                         \
+            if (child + 1 < size &&                                                   \
+                queue->entries[child + 1].key < queue->entries[child].key) {          \
+                child++;                                                              \
+            }                                                                         \
+            if (queue->entries[child].key >= last.key) {                              \
+                break;                                                                \
+            }                                                                         \
+            queue->entries[hole] = queue->entries[child];                             \
+            hole = child;                                                             \
+            STATS_COUNT(heapSiftLevels, 1);                                           \
+        }                                                                             \
+        queue->entries[hole] = last;                                                  \
+    }                                                                                 \
+    *key = top.key;                                                                   \
+    return top.id;                                                                    \
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Search counters and the per-thread struct they go to; only needed
+ * with -DSEARCH_STATS.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <string.h>
+#include <time.h>
+#include "stats.h"
+
+#ifdef SEARCH_STATS
+
+_Thread_local SearchStats searchStats;
+_Thread_local SearchStats* currentSearchStats;
+
+SearchStats* setSearchStats(SearchStats* stats) {
+    SearchStats* previous = currentSearchStats;
+    currentSearchStats = stats;
+    return previous;
+}
+
+void resetSearchStats(void) {
+    memset(&searchStats, 0, sizeof(searchStats));
+}
+
+SearchStats getSearchStats(void) {
+    return searchStats;
+}
+
+double statsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#endif
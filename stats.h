@@ -0,0 +1,97 @@
+/*
+ * Optional instrumentation of the search loops.
+ *
+ * Built with -DSEARCH_STATS (and stats.c), the heaps, Prim's and
+ * Dijkstra's algorithms and path building add to the counters and
+ * timers of a SearchStats. To get them alongside a query's results, hand
+ * a zeroed struct to setSearchStats before the query and restore the
+ * previous one after it:
+ *
+ *   SearchStats stats = {0};
+ *   SearchStats* previous = setSearchStats(&stats);
+ *   Edge* tree = getDistanceTreeDijkstra(graph, start);
+ *   setSearchStats(previous);
+ *
+ * Like the current arena, the struct is chosen per thread: a search adds
+ * only to the struct set by the thread it runs on, so threads that each
+ * set their own never interfere. The adds are not atomic, so a struct
+ * must not be set by two threads at once; give each worker its own and
+ * sum them afterwards. A thread that set none adds to a thread-local
+ * struct read by getSearchStats and zeroed by resetSearchStats.
+ *
+ * Without SEARCH_STATS the counting macros expand to nothing, so
+ * instrumented code compiles to what it was, the struct is left alone
+ * and getSearchStats always returns zeros.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+
+typedef struct searchStats
+{
+  long heapPushes;       // ids added to a heap
+  long heapPops;         // extract-mins
+  long heapDecreases;    // priorities lowered in place
+  long heapSiftLevels;   // levels moved by swap / floatUp / heapify and
+                         //   the sifts of the pq.c backends
+  long edgesScanned;     // out-edges looked at by a search loop
+  long relaxations;      // of those, the ones that lowered a key
+  double initSeconds;    // initRecords and other per-search setup
+  double loopSeconds;    // main loops of the searches
+  double pathSeconds;    // getShortestPaths, makePath included
+} SearchStats;
+
+#ifdef SEARCH_STATS
+
+extern _Thread_local SearchStats searchStats;
+extern _Thread_local SearchStats* currentSearchStats;
+
+/*
+ * Makes 'stats' the struct the calling thread's searches add to, or the
+ * thread-local one if 'stats' is NULL, and returns the previous one
+ * (NULL for the thread-local one). 'stats' is not zeroed.
+ */
+SearchStats* setSearchStats(SearchStats* stats);
+
+/*
+ * Zeroes the calling thread's thread-local counters and timers.
+ */
+void resetSearchStats(void);
+
+/*
+ * Returns the calling thread's thread-local counters and timers,
+ * accumulated since the last resetSearchStats while no other struct
+ * was set.
+ */
+SearchStats getSearchStats(void);
+
+double statsNow(void);
+
+#define STATS_TARGET (currentSearchStats != NULL ? currentSearchStats : &searchStats)
+#define STATS_COUNT(field, n) (STATS_TARGET->field += (n))
+#define STATS_TIMER(name) double name = statsNow()
+#define STATS_ADD_TIME(field, name) (STATS_TARGET->field += statsNow() - (name))
+
+#else
+
+static inline SearchStats* setSearchStats(SearchStats* stats) {
+    (void)stats;
+    return NULL;
+}
+
+static inline void resetSearchStats(void) {}
+
+static inline SearchStats getSearchStats(void) {
+    SearchStats none = {0};
+    return none;
+}
+
+#define STATS_COUNT(field, n) ((void)0)
+#define STATS_TIMER(name) ((void)0)
+#define STATS_ADD_TIME(field, name) ((void)0)
+
+#endif
+
+#endif